@@ -0,0 +1,61 @@
+#include <benchmark/benchmark.h>
+#include <memory_resource>
+#include "circular-buffer.h"
+#include "large-page-resource.h"
+
+// Стоимость создания и уничтожения короткоживущего буфера
+// с глобальной кучей и с пулом std::pmr
+
+template <class Buffer>
+static void Touch(Buffer& cb) {
+    cb.push_back(1);
+    benchmark::DoNotOptimize(cb.back());
+}
+
+static void ShortLivedHeap(benchmark::State& state) {
+    int capacity = static_cast<int>(state.range(0));
+    for (auto _ : state) {
+        CircularBuffer<int> cb(capacity);
+        Touch(cb);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void ShortLivedPool(benchmark::State& state) {
+    int capacity = static_cast<int>(state.range(0));
+    std::pmr::unsynchronized_pool_resource pool;
+    for (auto _ : state) {
+        PmrCircularBuffer<int> cb(capacity, &pool);
+        Touch(cb);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(ShortLivedHeap)->Arg(16)->Arg(256)->Arg(4096);
+BENCHMARK(ShortLivedPool)->Arg(16)->Arg(256)->Arg(4096);
+
+// Произвольный доступ через operator[] к большому кольцу: на обычных страницах
+// упирается в промахи TLB, большие страницы их сокращают.
+// Аргумент: 1 — запрашивать большие страницы, 0 — нет
+static void LargeRingRandomIndex(benchmark::State& state) {
+    const int capacity = 256 << 20;
+    LargePageOptions options;
+    options.huge_pages = state.range(0) != 0;
+    LargePageResource resource(options);
+    PmrCircularBuffer<char> cb(capacity, &resource);
+    cb.resize(capacity, 'x');
+    state.SetLabel(resource.last_backing().backing == PageBacking::Regular ? "regular" : "huge");
+
+    unsigned int x = 12345;
+    for (auto _ : state) {
+        int sum = 0;
+        for (int i = 0; i < 1024; ++i) {
+            x = x * 1664525u + 1013904223u;
+            sum += cb[static_cast<int>(x % capacity)];
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * 1024);
+}
+
+BENCHMARK(LargeRingRandomIndex)->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
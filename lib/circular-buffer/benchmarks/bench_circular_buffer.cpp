@@ -0,0 +1,170 @@
+#include <benchmark/benchmark.h>
+#include <vector>
+#include "circular-buffer.h"
+
+// Основной набор бенчмарков CircularBuffer<char>.
+// Аргументы: ёмкость в байтах (от 64 Б до 64 МиБ) и раскладка
+// (0 - данные линейны, 1 - данные переходят через конец массива).
+
+static void capacities_and_layouts(benchmark::internal::Benchmark* b) {
+    for (long long cap = 64; cap <= (64LL << 20); cap *= 16) {
+        b->Args({cap, 0});
+        b->Args({cap, 1});
+    }
+}
+
+// Заполняет буфер до size элементов в нужной раскладке
+static void fill(CircularBuffer<char>& cb, int size, bool wrapped) {
+    std::vector<char> chunk(cb.capacity(), 'x');
+    cb.clear();
+    if (wrapped) {
+        cb.push_back(chunk.data(), cb.capacity() / 2);
+        cb.consume(cb.capacity() / 2);
+    }
+    cb.push_back(chunk.data(), size);
+}
+
+static const char* layout_label(const benchmark::State& state) {
+    return state.range(1) ? "wrapped" : "linear";
+}
+
+static void BM_PushBackPopFront(benchmark::State& state) {
+    CircularBuffer<char> cb(static_cast<int>(state.range(0)));
+    fill(cb, cb.capacity() / 2, state.range(1) != 0);
+    for (auto _ : state) {
+        cb.push_back('y');
+        cb.pop_front();
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetLabel(layout_label(state));
+}
+
+static void BM_BulkPushPop(benchmark::State& state) {
+    CircularBuffer<char> cb(static_cast<int>(state.range(0)));
+    fill(cb, cb.capacity() / 2, state.range(1) != 0);
+    const int chunk = std::max(1, cb.capacity() / 4);
+    std::vector<char> in(chunk, 'y');
+    std::vector<char> out(chunk);
+    for (auto _ : state) {
+        cb.push_back(in.data(), chunk);
+        cb.pop_front(out.data(), chunk);
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * chunk * 2);
+    state.SetLabel(layout_label(state));
+}
+
+static void BM_IndexScan(benchmark::State& state) {
+    CircularBuffer<char> cb(static_cast<int>(state.range(0)));
+    fill(cb, cb.capacity(), state.range(1) != 0);
+    for (auto _ : state) {
+        int sum = 0;
+        for (int i = 0; i < cb.size(); ++i) {
+            sum += cb[i];
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetBytesProcessed(state.iterations() * cb.size());
+    state.SetLabel(layout_label(state));
+}
+
+static void BM_InsertEraseMiddle(benchmark::State& state) {
+    CircularBuffer<char> cb(static_cast<int>(state.range(0)));
+    fill(cb, cb.capacity() - 1, state.range(1) != 0);
+    const int middle = cb.size() / 2;
+    for (auto _ : state) {
+        cb.insert(middle, 'i');
+        cb.erase(middle, middle + 1);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * 2);
+    state.SetLabel(layout_label(state));
+}
+
+static void BM_InsertEraseNearFront(benchmark::State& state) {
+    CircularBuffer<char> cb(static_cast<int>(state.range(0)));
+    fill(cb, cb.capacity() - 1, state.range(1) != 0);
+    const int pos = cb.size() / 8;
+    for (auto _ : state) {
+        cb.insert(pos, 'i');
+        cb.erase(pos, pos + 1);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * 2);
+    state.SetLabel(layout_label(state));
+}
+
+static void BM_RangeInsertMiddle(benchmark::State& state) {
+    CircularBuffer<char> cb(static_cast<int>(state.range(0)));
+    fill(cb, cb.capacity() - 16, state.range(1) != 0);
+    const int middle = cb.size() / 2;
+    const char block[16] = {};
+    for (auto _ : state) {
+        cb.insert(middle, block, block + 16);
+        cb.erase(middle, middle + 16);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * 32);
+    state.SetLabel(layout_label(state));
+}
+
+static void BM_Linearize(benchmark::State& state) {
+    CircularBuffer<char> cb(static_cast<int>(state.range(0)));
+    for (auto _ : state) {
+        state.PauseTiming();
+        fill(cb, cb.capacity() - 1, state.range(1) != 0);
+        state.ResumeTiming();
+        benchmark::DoNotOptimize(cb.linearize());
+    }
+    state.SetBytesProcessed(state.iterations() * (state.range(0) - 1));
+    state.SetLabel(layout_label(state));
+}
+
+static void BM_SetCapacity(benchmark::State& state) {
+    const int cap = static_cast<int>(state.range(0));
+    CircularBuffer<char> cb(cap);
+    for (auto _ : state) {
+        state.PauseTiming();
+        cb.set_capacity(cap);
+        fill(cb, cap, state.range(1) != 0);
+        state.ResumeTiming();
+        cb.set_capacity(cap * 2);
+    }
+    state.SetBytesProcessed(state.iterations() * cap);
+    state.SetLabel(layout_label(state));
+}
+
+static void BM_CopyConstruct(benchmark::State& state) {
+    CircularBuffer<char> cb(static_cast<int>(state.range(0)));
+    fill(cb, cb.capacity(), state.range(1) != 0);
+    for (auto _ : state) {
+        CircularBuffer<char> copy(cb);
+        benchmark::DoNotOptimize(copy);
+    }
+    state.SetBytesProcessed(state.iterations() * cb.size());
+    state.SetLabel(layout_label(state));
+}
+
+static void BM_CopyAssign(benchmark::State& state) {
+    CircularBuffer<char> cb(static_cast<int>(state.range(0)));
+    fill(cb, cb.capacity(), state.range(1) != 0);
+    CircularBuffer<char> target(cb.capacity());
+    for (auto _ : state) {
+        target = cb;
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * cb.size());
+    state.SetLabel(layout_label(state));
+}
+
+BENCHMARK(BM_PushBackPopFront)->Apply(capacities_and_layouts);
+BENCHMARK(BM_BulkPushPop)->Apply(capacities_and_layouts);
+BENCHMARK(BM_IndexScan)->Apply(capacities_and_layouts);
+BENCHMARK(BM_InsertEraseMiddle)->Apply(capacities_and_layouts);
+BENCHMARK(BM_InsertEraseNearFront)->Apply(capacities_and_layouts);
+BENCHMARK(BM_RangeInsertMiddle)->Apply(capacities_and_layouts);
+BENCHMARK(BM_Linearize)->Apply(capacities_and_layouts);
+BENCHMARK(BM_SetCapacity)->Apply(capacities_and_layouts);
+BENCHMARK(BM_CopyConstruct)->Apply(capacities_and_layouts);
+BENCHMARK(BM_CopyAssign)->Apply(capacities_and_layouts);
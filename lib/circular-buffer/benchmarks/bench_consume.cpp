@@ -0,0 +1,94 @@
+#include <benchmark/benchmark.h>
+#include "circular-buffer.h"
+#include "spsc-circular-buffer.h"
+
+// Опустошение заполненного буфера: front/pop_front на каждый элемент
+// против consume_all с функтором по участкам и одним сдвигом головы
+
+static void DrainFrontPop(benchmark::State& state) {
+    CircularBuffer<int> cb(1 << 16);
+    benchmark::DoNotOptimize(&cb);
+    long long sum = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        // Сдвиг на половину, чтобы элементы переходили через конец памяти
+        for (int i = 0; i < cb.capacity() / 2; ++i) {
+            cb.push_back(i);
+        }
+        cb.consume(cb.size());
+        for (int i = 0; i < cb.capacity(); ++i) {
+            cb.push_back(i);
+        }
+        state.ResumeTiming();
+        while (!cb.empty()) {
+            sum += cb.front();
+            cb.pop_front();
+        }
+    }
+    benchmark::DoNotOptimize(sum);
+    state.SetItemsProcessed(state.iterations() * (1 << 16));
+}
+
+static void DrainConsumeAll(benchmark::State& state) {
+    CircularBuffer<int> cb(1 << 16);
+    benchmark::DoNotOptimize(&cb);
+    long long sum = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        // Сдвиг на половину, чтобы элементы переходили через конец памяти
+        for (int i = 0; i < cb.capacity() / 2; ++i) {
+            cb.push_back(i);
+        }
+        cb.consume(cb.size());
+        for (int i = 0; i < cb.capacity(); ++i) {
+            cb.push_back(i);
+        }
+        state.ResumeTiming();
+        cb.consume_all([&sum](const int* first, const int* last) {
+            for (; first != last; ++first) {
+                sum += *first;
+            }
+        });
+    }
+    benchmark::DoNotOptimize(sum);
+    state.SetItemsProcessed(state.iterations() * (1 << 16));
+}
+
+// То же для SPSC: одна атомарная запись head на пакет вместо записи на элемент
+static void SpscDrainTryPop(benchmark::State& state) {
+    SpscCircularBuffer cb(4096);
+    long long sum = 0;
+    for (auto _ : state) {
+        for (int i = 0; i < 4096; ++i) {
+            cb.try_push(static_cast<SpscCircularBuffer::value_type>(i));
+        }
+        SpscCircularBuffer::value_type item;
+        while (cb.try_pop(item)) {
+            sum += item;
+        }
+    }
+    benchmark::DoNotOptimize(sum);
+    state.SetItemsProcessed(state.iterations() * 4096);
+}
+
+static void SpscDrainConsumeAll(benchmark::State& state) {
+    SpscCircularBuffer cb(4096);
+    long long sum = 0;
+    for (auto _ : state) {
+        for (int i = 0; i < 4096; ++i) {
+            cb.try_push(static_cast<SpscCircularBuffer::value_type>(i));
+        }
+        cb.consume_all([&sum](const SpscCircularBuffer::value_type* first, const SpscCircularBuffer::value_type* last) {
+            for (; first != last; ++first) {
+                sum += *first;
+            }
+        });
+    }
+    benchmark::DoNotOptimize(sum);
+    state.SetItemsProcessed(state.iterations() * 4096);
+}
+
+BENCHMARK(DrainFrontPop);
+BENCHMARK(DrainConsumeAll);
+BENCHMARK(SpscDrainTryPop);
+BENCHMARK(SpscDrainConsumeAll);
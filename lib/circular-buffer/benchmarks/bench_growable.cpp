@@ -0,0 +1,43 @@
+#include <benchmark/benchmark.h>
+#include <deque>
+#include "growable-circular-buffer.h"
+
+// Пачками кладём и забираем элементы: растущее кольцо против std::deque.
+// Буфер создаётся один раз, поэтому после первой пачки рост не повторяется
+
+template <class Queue>
+static void Burst(benchmark::State& state) {
+    const int burst = static_cast<int>(state.range(0));
+    Queue queue;
+    long long sum = 0;
+    for (auto _ : state) {
+        for (int i = 0; i < burst; ++i) {
+            queue.push_back(i);
+        }
+        while (!queue.empty()) {
+            sum += queue.front();
+            queue.pop_front();
+        }
+    }
+    benchmark::DoNotOptimize(sum);
+    state.SetItemsProcessed(state.iterations() * burst * 2);
+}
+
+// Рост с нуля: амортизированная стоимость push_back вместе с перевыделениями
+template <class Queue>
+static void GrowFromEmpty(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    for (auto _ : state) {
+        Queue queue;
+        for (int i = 0; i < n; ++i) {
+            queue.push_back(i);
+        }
+        benchmark::DoNotOptimize(queue.back());
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK_TEMPLATE(Burst, GrowableCircularBuffer<int>)->Arg(64)->Arg(4096)->Arg(1 << 18);
+BENCHMARK_TEMPLATE(Burst, std::deque<int>)->Arg(64)->Arg(4096)->Arg(1 << 18);
+BENCHMARK_TEMPLATE(GrowFromEmpty, GrowableCircularBuffer<int>)->Arg(4096)->Arg(1 << 18);
+BENCHMARK_TEMPLATE(GrowFromEmpty, std::deque<int>)->Arg(4096)->Arg(1 << 18);
@@ -0,0 +1,86 @@
+#include <benchmark/benchmark.h>
+#include "circular-buffer.h"
+#include "masked-circular-buffer.h"
+#include "static-circular-buffer.h"
+
+// Сравнение индексации через % (CircularBuffer) и через маску (MaskedCircularBuffer)
+
+template <class Buffer>
+static void PushPop(benchmark::State& state) {
+    Buffer cb(static_cast<int>(state.range(0)));
+    for (int i = 0; i < cb.capacity() / 2; ++i) {
+        cb.push_back('x');
+    }
+    for (auto _ : state) {
+        cb.push_back('y');
+        cb.pop_front();
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template <class Buffer>
+static void PushOverwrite(benchmark::State& state) {
+    Buffer cb(static_cast<int>(state.range(0)));
+    char c = 0;
+    for (auto _ : state) {
+        cb.push_back(c++);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template <class Buffer>
+static void IndexScan(benchmark::State& state) {
+    Buffer cb(static_cast<int>(state.range(0)));
+    for (int i = 0; i < cb.capacity() + cb.capacity() / 3; ++i) {
+        cb.push_back(static_cast<char>(i));
+    }
+    for (auto _ : state) {
+        int sum = 0;
+        for (int i = 0; i < cb.size(); ++i) {
+            sum += cb[i];
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * cb.size());
+}
+
+BENCHMARK_TEMPLATE(PushPop, CircularBuffer<>)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(PushPop, MaskedCircularBuffer)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(PushOverwrite, CircularBuffer<>)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(PushOverwrite, MaskedCircularBuffer)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(IndexScan, CircularBuffer<>)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(IndexScan, MaskedCircularBuffer)->Arg(1 << 10)->Arg(1 << 16);
+
+// Ёмкость, известная на этапе компиляции: деление заменяется маской без хранения маски
+static void StaticPushPop(benchmark::State& state) {
+    StaticCircularBuffer<char, 1024> cb;
+    for (int i = 0; i < cb.capacity() / 2; ++i) {
+        cb.push_back('x');
+    }
+    for (auto _ : state) {
+        cb.push_back('y');
+        cb.pop_front();
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void StaticIndexScan(benchmark::State& state) {
+    StaticCircularBuffer<char, 1024> cb;
+    for (int i = 0; i < cb.capacity() + cb.capacity() / 3; ++i) {
+        cb.push_back(static_cast<char>(i));
+    }
+    for (auto _ : state) {
+        int sum = 0;
+        for (int i = 0; i < cb.size(); ++i) {
+            sum += cb[i];
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * cb.size());
+}
+
+BENCHMARK(StaticPushPop);
+BENCHMARK(StaticIndexScan);
@@ -0,0 +1,116 @@
+#include <benchmark/benchmark.h>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include "circular-buffer.h"
+
+// Аллокатор, считающий выделения памяти буфера
+template <class T>
+struct CountingAllocator {
+    typedef T value_type;
+
+    long long* allocations;
+
+    explicit CountingAllocator(long long* counter) : allocations(counter) {}
+
+    template <class U>
+    CountingAllocator(const CountingAllocator<U>& other) : allocations(other.allocations) {}
+
+    T* allocate(std::size_t n) {
+        ++*allocations;
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T* p, std::size_t n) {
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    friend bool operator==(const CountingAllocator& a, const CountingAllocator& b) {
+        return a.allocations == b.allocations;
+    }
+
+    friend bool operator!=(const CountingAllocator& a, const CountingAllocator& b) { return !(a == b); }
+};
+
+typedef CircularBuffer<char, CountingAllocator<char>> CountedBuffer;
+
+// Заполняет буфер и сдвигает начало на треть, чтобы данные переходили через конец массива
+static void make_wrapped(CountedBuffer& cb, const std::vector<char>& chunk) {
+    cb.clear();
+    cb.push_back(chunk.data(), cb.capacity());
+    cb.consume(cb.capacity() / 3);
+    cb.push_back(chunk.data(), cb.capacity() / 3 - 1);
+}
+
+// Линеаризация на месте
+static void LinearizeInPlace(benchmark::State& state) {
+    long long allocations = 0;
+    CountedBuffer cb(static_cast<int>(state.range(0)), CountingAllocator<char>(&allocations));
+    std::vector<char> chunk(cb.capacity(), 'x');
+    long long allocs = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        make_wrapped(cb, chunk);
+        long long before = allocations;
+        state.ResumeTiming();
+
+        benchmark::DoNotOptimize(cb.linearize());
+
+        allocs += allocations - before;
+    }
+    state.counters["allocs_per_call"] = benchmark::Counter(
+        static_cast<double>(allocs), benchmark::Counter::kAvgIterations);
+    state.SetBytesProcessed(state.iterations() * cb.size());
+}
+
+// Прежний способ для сравнения: новый массив, копирование и освобождение старого
+static void LinearizeByCopy(benchmark::State& state) {
+    long long allocations = 0;
+    CountedBuffer cb(static_cast<int>(state.range(0)), CountingAllocator<char>(&allocations));
+    std::vector<char> chunk(cb.capacity(), 'x');
+    long long allocs = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        make_wrapped(cb, chunk);
+        long long before = allocations;
+        state.ResumeTiming();
+
+        CountingAllocator<char> alloc = cb.get_allocator();
+        char* copy = alloc.allocate(cb.capacity());
+        auto parts = cb.read_regions();
+        std::memcpy(copy, parts[0].data, parts[0].size);
+        std::memcpy(copy + parts[0].size, parts[1].data, parts[1].size);
+        benchmark::DoNotOptimize(copy);
+        alloc.deallocate(copy, cb.capacity());
+
+        allocs += allocations - before;
+    }
+    state.counters["allocs_per_call"] = benchmark::Counter(
+        static_cast<double>(allocs), benchmark::Counter::kAvgIterations);
+    state.SetBytesProcessed(state.iterations() * cb.size());
+}
+
+// Поворот неполного буфера с последующей линеаризацией
+static void RotateThenLinearize(benchmark::State& state) {
+    long long allocations = 0;
+    CountedBuffer cb(static_cast<int>(state.range(0)), CountingAllocator<char>(&allocations));
+    std::vector<char> chunk(cb.capacity(), 'x');
+    long long allocs = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        make_wrapped(cb, chunk);
+        long long before = allocations;
+        state.ResumeTiming();
+
+        cb.rotate(cb.size() / 8);
+        benchmark::DoNotOptimize(cb.linearize());
+
+        allocs += allocations - before;
+    }
+    state.counters["allocs_per_call"] = benchmark::Counter(
+        static_cast<double>(allocs), benchmark::Counter::kAvgIterations);
+}
+
+BENCHMARK(LinearizeInPlace)->Arg(1 << 12)->Arg(1 << 20);
+BENCHMARK(LinearizeByCopy)->Arg(1 << 12)->Arg(1 << 20);
+BENCHMARK(RotateThenLinearize)->Arg(1 << 12)->Arg(1 << 20);
@@ -0,0 +1,84 @@
+#include <benchmark/benchmark.h>
+#include <mutex>
+#include "circular-buffer.h"
+#include "mpmc-circular-buffer.h"
+
+// Масштабирование очереди под конкурентной нагрузкой от 1 до N потоков.
+// Каждый поток поочерёдно кладёт и забирает элементы, поэтому очередь никогда
+// не переполняется и не пустеет надолго, а счётчик items_per_second делится на потоки
+// (см. items_per_second с суффиксом /threads:N в отчёте)
+
+static const int queue_capacity = 1024;
+static const int batch_size = 16;
+
+// Базовый вариант: CircularBuffer под одним глобальным мьютексом
+struct MutexQueue {
+    std::mutex lock;
+    CircularBuffer<int> cb;
+
+    MutexQueue() : cb(queue_capacity) {}
+
+    bool try_push(int item) {
+        std::lock_guard<std::mutex> guard(lock);
+        if (cb.full()) {
+            return false;
+        }
+        cb.push_back(item);
+        return true;
+    }
+
+    bool try_pop(int& item) {
+        std::lock_guard<std::mutex> guard(lock);
+        if (cb.empty()) {
+            return false;
+        }
+        item = cb.front();
+        cb.pop_front();
+        return true;
+    }
+};
+
+static MutexQueue mutex_queue;
+static MpmcCircularBuffer<int> mpmc_queue(queue_capacity);
+
+template <class Queue>
+static void PushPop(benchmark::State& state, Queue& queue) {
+    int item = state.thread_index();
+    for (auto _ : state) {
+        while (!queue.try_push(item)) {
+        }
+        while (!queue.try_pop(item)) {
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * 2);
+}
+
+static void MutexPushPop(benchmark::State& state) {
+    PushPop(state, mutex_queue);
+}
+
+static void MpmcPushPop(benchmark::State& state) {
+    PushPop(state, mpmc_queue);
+}
+
+// Пакетные операции: одно обновление позиции на batch_size элементов
+static void MpmcBatchPushPop(benchmark::State& state) {
+    int data[batch_size] = {};
+    int out[batch_size];
+    for (auto _ : state) {
+        int pushed = 0;
+        while (pushed < batch_size) {
+            pushed += mpmc_queue.try_push_n(data + pushed, batch_size - pushed);
+        }
+        int popped = 0;
+        while (popped < batch_size) {
+            popped += mpmc_queue.try_pop_n(out + popped, batch_size - popped);
+        }
+        benchmark::DoNotOptimize(out);
+    }
+    state.SetItemsProcessed(state.iterations() * 2 * batch_size);
+}
+
+BENCHMARK(MutexPushPop)->ThreadRange(1, 16)->UseRealTime();
+BENCHMARK(MpmcPushPop)->ThreadRange(1, 16)->UseRealTime();
+BENCHMARK(MpmcBatchPushPop)->ThreadRange(1, 16)->UseRealTime();
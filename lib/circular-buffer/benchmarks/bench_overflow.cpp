@@ -0,0 +1,57 @@
+#include <benchmark/benchmark.h>
+#include "overflow-circular-buffer.h"
+
+// Поток push_back в полный буфер: каждая вставка переполняет его.
+// Политика выбирается при компиляции, поэтому перезапись должна стоить
+// столько же, сколько в CircularBuffer, плюс инкремент счётчика
+
+struct CountEvicted {
+    long long sum = 0;
+
+    void operator()(int& item) { sum += item; }
+};
+
+template <class Buffer>
+static void PushFull(benchmark::State& state) {
+    Buffer cb(1024);
+    for (int i = 0; i < cb.capacity(); ++i) {
+        cb.push_back(i);
+    }
+    // Буфер должен быть виден извне, иначе компилятор выбросит вставки
+    benchmark::DoNotOptimize(&cb);
+    int value = 0;
+    for (auto _ : state) {
+        cb.push_back(++value);
+        benchmark::ClobberMemory();
+    }
+    benchmark::DoNotOptimize(cb.front());
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Буфер заполняется наполовину и сразу опустошается: переполнения нет,
+// измеряется только цена проверки политики
+template <class Buffer>
+static void PushPopHalf(benchmark::State& state) {
+    Buffer cb(1024);
+    benchmark::DoNotOptimize(&cb);
+    long long sum = 0;
+    for (auto _ : state) {
+        for (int i = 0; i < 512; ++i) {
+            cb.push_back(i);
+        }
+        while (!cb.empty()) {
+            sum += cb.front();
+            cb.pop_front();
+        }
+    }
+    benchmark::DoNotOptimize(sum);
+    state.SetItemsProcessed(state.iterations() * 1024);
+}
+
+BENCHMARK_TEMPLATE(PushFull, CircularBuffer<int>);
+BENCHMARK_TEMPLATE(PushFull, OverflowCircularBuffer<int, OverwriteOldest>);
+BENCHMARK_TEMPLATE(PushFull, OverflowCircularBuffer<int, RejectNew>);
+BENCHMARK_TEMPLATE(PushFull, OverflowCircularBuffer<int, EvictCallback<CountEvicted>>);
+BENCHMARK_TEMPLATE(PushPopHalf, CircularBuffer<int>);
+BENCHMARK_TEMPLATE(PushPopHalf, OverflowCircularBuffer<int, OverwriteOldest>);
+BENCHMARK_TEMPLATE(PushPopHalf, OverflowCircularBuffer<int, RejectNew>);
@@ -0,0 +1,68 @@
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <string>
+#include <unistd.h>
+#include "circular-buffer.h"
+#include "persistent-circular-buffer.h"
+
+// Вставка в кольцо, отображённое из файла, по сравнению с обычным буфером.
+// Данные пишутся прямо в страничный кэш, поэтому разница сводится к двум
+// атомарным счётчикам в заголовке; на диск ничего не уходит до checkpoint
+
+static std::string bench_ring_path(const char* name) {
+    return "/tmp/bench-ring-" + std::to_string(getpid()) + "-" + name;
+}
+
+static void PushFullInMemory(benchmark::State& state) {
+    CircularBuffer<long long> cb(4096);
+    for (int i = 0; i < cb.capacity(); ++i) {
+        cb.push_back(i);
+    }
+    benchmark::DoNotOptimize(&cb);
+    long long value = 0;
+    for (auto _ : state) {
+        cb.push_back(++value);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void PushFullPersistent(benchmark::State& state) {
+    std::string path = bench_ring_path("push");
+    std::remove(path.c_str());
+    {
+        PersistentCircularBuffer<long long> ring(path, 4096);
+        benchmark::DoNotOptimize(&ring);
+        long long value = 0;
+        for (auto _ : state) {
+            ring.push_back(++value);
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(state.iterations());
+    }
+    std::remove(path.c_str());
+}
+
+// Пакет из range(0) вставок, завершаемый checkpoint: цена долговечности на элемент
+static void PushBatchCheckpoint(benchmark::State& state) {
+    std::string path = bench_ring_path("checkpoint");
+    std::remove(path.c_str());
+    {
+        PersistentCircularBuffer<long long> ring(path, 4096);
+        const int batch = static_cast<int>(state.range(0));
+        const bool wait = state.range(1) != 0;
+        long long value = 0;
+        for (auto _ : state) {
+            for (int i = 0; i < batch; ++i) {
+                ring.push_back(++value);
+            }
+            ring.checkpoint(wait);
+        }
+        state.SetItemsProcessed(state.iterations() * batch);
+    }
+    std::remove(path.c_str());
+}
+
+BENCHMARK(PushFullInMemory);
+BENCHMARK(PushFullPersistent);
+BENCHMARK(PushBatchCheckpoint)->ArgNames({"batch", "wait"})->Args({64, 0})->Args({4096, 0})->Args({64, 1})->Args({4096, 1});
@@ -0,0 +1,70 @@
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "circular-buffer.h"
+#include "record-ring.h"
+
+// Очередь сообщений длиной range(0) байт поверх байтового кольца.
+// Базовый вариант — ручной префикс длины в CircularBuffer<char> с копией
+// каждого сообщения в std::string при чтении; RecordRing читает на месте
+
+static void ManualLengthPrefix(benchmark::State& state) {
+    const int size = static_cast<int>(state.range(0));
+    CircularBuffer<char> cb(1 << 16);
+    std::vector<char> message(size, 'm');
+    std::uint32_t length = static_cast<std::uint32_t>(size);
+    long long total = 0;
+    for (auto _ : state) {
+        for (int i = 0; i < 64; ++i) {
+            cb.push_back(reinterpret_cast<const char*>(&length), sizeof(length));
+            cb.push_back(message.data(), size);
+        }
+        while (!cb.empty()) {
+            std::uint32_t n;
+            cb.pop_front(reinterpret_cast<char*>(&n), sizeof(n));
+            std::string payload(n, '\0');
+            cb.pop_front(&payload[0], static_cast<int>(n));
+            total += payload.size();
+        }
+    }
+    benchmark::DoNotOptimize(total);
+    state.SetItemsProcessed(state.iterations() * 64);
+}
+
+static void RecordRingPopEach(benchmark::State& state) {
+    const int size = static_cast<int>(state.range(0));
+    RecordRing ring(1 << 16);
+    std::vector<char> message(size, 'm');
+    long long total = 0;
+    for (auto _ : state) {
+        for (int i = 0; i < 64; ++i) {
+            ring.push_record(message.data(), message.size());
+        }
+        while (!ring.empty()) {
+            total += ring.peek_record().size;
+            ring.pop_record();
+        }
+    }
+    benchmark::DoNotOptimize(total);
+    state.SetItemsProcessed(state.iterations() * 64);
+}
+
+static void RecordRingDrain(benchmark::State& state) {
+    const int size = static_cast<int>(state.range(0));
+    RecordRing ring(1 << 16);
+    std::vector<char> message(size, 'm');
+    long long total = 0;
+    for (auto _ : state) {
+        for (int i = 0; i < 64; ++i) {
+            ring.push_record(message.data(), message.size());
+        }
+        ring.drain([&](RecordView record) { total += record.size; });
+    }
+    benchmark::DoNotOptimize(total);
+    state.SetItemsProcessed(state.iterations() * 64);
+}
+
+BENCHMARK(ManualLengthPrefix)->Arg(16)->Arg(200);
+BENCHMARK(RecordRingPopEach)->Arg(16)->Arg(200);
+BENCHMARK(RecordRingDrain)->Arg(16)->Arg(200);
@@ -0,0 +1,137 @@
+#include <benchmark/benchmark.h>
+#include <string>
+#include "circular-buffer.h"
+#include "simd-scan.h"
+
+// Поиск в байтовом кольце: строки по 80 байт в буфере на 64 КиБ, данные
+// переходят через конец массива. Аргумент - уровень ядер
+// (0 - скалярный, 1 - SSE2, 2 - AVX2); наивные варианты идут через operator[]
+
+static const int ring_size = 64 << 10;
+
+// Заполняет кольцо строками текста; каждая строка оканчивается на "\r\n"
+static void fill_lines(CircularBuffer<char>& cb) {
+    std::string line(78, 'x');
+    line += "\r\n";
+    cb.push_back(line.data(), ring_size / 3);
+    cb.consume(ring_size / 3);
+    while (cb.reserve() >= static_cast<int>(line.size())) {
+        cb.push_back(line.data(), static_cast<int>(line.size()));
+    }
+}
+
+static bool use_level(benchmark::State& state) {
+    ScanLevel level = static_cast<ScanLevel>(state.range(0));
+    if (set_scan_level(level) != level) {
+        state.SkipWithError("Instruction set is not supported");
+        return false;
+    }
+    return true;
+}
+
+static void BM_FindLines(benchmark::State& state) {
+    if (!use_level(state)) {
+        return;
+    }
+    CircularBuffer<char> cb(ring_size);
+    fill_lines(cb);
+    for (auto _ : state) {
+        int lines = 0;
+        for (int i = cb.find('\n'); i >= 0; i = cb.find('\n', i + 1)) {
+            ++lines;
+        }
+        benchmark::DoNotOptimize(lines);
+    }
+    state.SetBytesProcessed(state.iterations() * cb.size());
+}
+
+static void BM_FindLinesNaive(benchmark::State& state) {
+    CircularBuffer<char> cb(ring_size);
+    fill_lines(cb);
+    for (auto _ : state) {
+        int lines = 0;
+        for (int i = 0; i < cb.size(); ++i) {
+            lines += cb[i] == '\n';
+        }
+        benchmark::DoNotOptimize(lines);
+    }
+    state.SetBytesProcessed(state.iterations() * cb.size());
+}
+
+static void BM_Count(benchmark::State& state) {
+    if (!use_level(state)) {
+        return;
+    }
+    CircularBuffer<char> cb(ring_size);
+    fill_lines(cb);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(segmented_count(cb, '\r'));
+    }
+    state.SetBytesProcessed(state.iterations() * cb.size());
+}
+
+// Конец заголовков HTTP ищется в самом конце кольца, "\r" встречается в каждой строке
+static void BM_FindHeaderEnd(benchmark::State& state) {
+    if (!use_level(state)) {
+        return;
+    }
+    CircularBuffer<char> cb(ring_size);
+    fill_lines(cb);
+    cb.push_back("\r\n", 2);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(cb.find("\r\n\r\n", 4));
+    }
+    state.SetBytesProcessed(state.iterations() * cb.size());
+}
+
+static void BM_FindHeaderEndNaive(benchmark::State& state) {
+    CircularBuffer<char> cb(ring_size);
+    fill_lines(cb);
+    cb.push_back("\r\n", 2);
+    for (auto _ : state) {
+        int found = -1;
+        for (int i = 0; i + 4 <= cb.size(); ++i) {
+            if (cb[i] == '\r' && cb[i + 1] == '\n' && cb[i + 2] == '\r' && cb[i + 3] == '\n') {
+                found = i;
+                break;
+            }
+        }
+        benchmark::DoNotOptimize(found);
+    }
+    state.SetBytesProcessed(state.iterations() * cb.size());
+}
+
+// Сравнение двух колец с разными точками разреза
+static void BM_Equal(benchmark::State& state) {
+    CircularBuffer<char> a(ring_size);
+    fill_lines(a);
+    CircularBuffer<char> b(a);
+    b.linearize();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a == b);
+    }
+    state.SetBytesProcessed(state.iterations() * a.size());
+}
+
+static void BM_EqualNaive(benchmark::State& state) {
+    CircularBuffer<char> a(ring_size);
+    fill_lines(a);
+    CircularBuffer<char> b(a);
+    b.linearize();
+    for (auto _ : state) {
+        bool equal = a.size() == b.size();
+        for (int i = 0; equal && i < a.size(); ++i) {
+            equal = a[i] == b[i];
+        }
+        benchmark::DoNotOptimize(equal);
+    }
+    state.SetBytesProcessed(state.iterations() * a.size());
+}
+
+BENCHMARK(BM_FindLines)->DenseRange(0, 2);
+BENCHMARK(BM_FindLinesNaive);
+BENCHMARK(BM_Count)->DenseRange(0, 2);
+BENCHMARK(BM_FindHeaderEnd)->DenseRange(0, 2);
+BENCHMARK(BM_FindHeaderEndNaive);
+BENCHMARK(BM_Equal);
+BENCHMARK(BM_EqualNaive);
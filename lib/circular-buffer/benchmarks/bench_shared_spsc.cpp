@@ -0,0 +1,81 @@
+#include <benchmark/benchmark.h>
+#include <csignal>
+#include <string>
+#include <vector>
+#include <sched.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "shared-spsc-circular-buffer.h"
+
+// Передача сообщений размера range(0) байт в дочерний процесс:
+// через кольцо в разделяемой памяти и, для сравнения, через pipe.
+// Потребитель читает, пока его не завершат; замеряется сторона производителя
+
+// Останавливает и дожидается потребителя
+static void stop_consumer(pid_t child) {
+    kill(child, SIGKILL);
+    waitpid(child, nullptr, 0);
+}
+
+static void SharedRingThroughput(benchmark::State& state) {
+    const int message = static_cast<int>(state.range(0));
+    SharedSpscCircularBuffer ring("/cb-bench-" + std::to_string(getpid()), 1 << 16);
+    pid_t child = fork();
+    if (child == 0) {
+        SharedSpscCircularBuffer in(ring.name());
+        std::vector<char> buf(message);
+        for (;;) {
+            if (in.try_pop(buf.data(), message) == 0) {
+                sched_yield();
+            }
+        }
+    }
+    std::vector<char> data(message, 'x');
+    for (auto _ : state) {
+        int pushed = 0;
+        while (pushed < message) {
+            int k = ring.try_push(data.data() + pushed, message - pushed);
+            if (k == 0) {
+                sched_yield();
+            }
+            pushed += k;
+        }
+    }
+    stop_consumer(child);
+    state.SetBytesProcessed(state.iterations() * message);
+}
+
+static void PipeThroughput(benchmark::State& state) {
+    const int message = static_cast<int>(state.range(0));
+    int fds[2];
+    if (pipe(fds) != 0) {
+        state.SkipWithError("pipe failed");
+        return;
+    }
+    pid_t child = fork();
+    if (child == 0) {
+        close(fds[1]);
+        std::vector<char> buf(message);
+        while (read(fds[0], buf.data(), buf.size()) > 0) {
+        }
+        _exit(0);
+    }
+    close(fds[0]);
+    std::vector<char> data(message, 'x');
+    for (auto _ : state) {
+        for (int written = 0; written < message;) {
+            ssize_t k = write(fds[1], data.data() + written, message - written);
+            if (k <= 0) {
+                state.SkipWithError("write failed");
+                break;
+            }
+            written += static_cast<int>(k);
+        }
+    }
+    close(fds[1]);
+    stop_consumer(child);
+    state.SetBytesProcessed(state.iterations() * message);
+}
+
+BENCHMARK(SharedRingThroughput)->Arg(64)->Arg(4096);
+BENCHMARK(PipeThroughput)->Arg(64)->Arg(4096);
@@ -0,0 +1,46 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include "circular-buffer.h"
+#include "sliding-window.h"
+
+// Скользящее окно размера range(0): пересчёт суммы, минимума и максимума
+// обходом через operator[] на каждом шаге против SlidingWindow
+
+static void WindowRescan(benchmark::State& state) {
+    const int size = static_cast<int>(state.range(0));
+    CircularBuffer<double> window(size);
+    double x = 0;
+    double acc = 0;
+    for (auto _ : state) {
+        window.push_back(x);
+        x = x * 0.75 + 1.0;
+        double sum = 0;
+        double lo = window[0];
+        double hi = window[0];
+        for (int i = 0; i < window.size(); ++i) {
+            sum += window[i];
+            lo = std::min(lo, window[i]);
+            hi = std::max(hi, window[i]);
+        }
+        acc += sum / window.size() + lo + hi;
+    }
+    benchmark::DoNotOptimize(acc);
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void WindowIncremental(benchmark::State& state) {
+    const int size = static_cast<int>(state.range(0));
+    SlidingWindow<double> window(size);
+    double x = 0;
+    double acc = 0;
+    for (auto _ : state) {
+        window.push_back(x);
+        x = x * 0.75 + 1.0;
+        acc += window.mean() + window.min() + window.max() + window.variance();
+    }
+    benchmark::DoNotOptimize(acc);
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(WindowRescan)->Arg(64)->Arg(1024);
+BENCHMARK(WindowIncremental)->Arg(64)->Arg(1024);
@@ -0,0 +1,43 @@
+#include <benchmark/benchmark.h>
+#include "instrumented-circular-buffer.h"
+
+// Цена сбора статистики на горячем пути: вставка с удалением в буфере,
+// заполненном наполовину, и вставка в полный буфер с перезаписью
+
+template <class Buffer>
+static void StatsPushPop(benchmark::State& state) {
+    Buffer cb(1024);
+    benchmark::DoNotOptimize(&cb);
+    for (int i = 0; i < 512; ++i) {
+        cb.push_back(i);
+    }
+    int value = 0;
+    for (auto _ : state) {
+        cb.push_back(++value);
+        cb.pop_front();
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * 2);
+}
+
+template <class Buffer>
+static void StatsPushFull(benchmark::State& state) {
+    Buffer cb(1024);
+    benchmark::DoNotOptimize(&cb);
+    for (int i = 0; i < 1024; ++i) {
+        cb.push_back(i);
+    }
+    int value = 0;
+    for (auto _ : state) {
+        cb.push_back(++value);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_TEMPLATE(StatsPushPop, CircularBuffer<int>);
+BENCHMARK_TEMPLATE(StatsPushPop, InstrumentedCircularBuffer<int, NullBufferStats>);
+BENCHMARK_TEMPLATE(StatsPushPop, InstrumentedCircularBuffer<int, BufferStats>);
+BENCHMARK_TEMPLATE(StatsPushFull, CircularBuffer<int>);
+BENCHMARK_TEMPLATE(StatsPushFull, InstrumentedCircularBuffer<int, NullBufferStats>);
+BENCHMARK_TEMPLATE(StatsPushFull, InstrumentedCircularBuffer<int, BufferStats>);
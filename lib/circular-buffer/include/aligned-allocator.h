@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+
+// Common alignments for AlignedAllocator
+static const std::size_t cache_line_alignment = 64;
+static const std::size_t page_alignment = 4096;
+
+// Allocator whose storage starts on an Alignment-byte boundary, e.g.
+// CircularBuffer<T, AlignedAllocator<T, cache_line_alignment>> keeps the
+// storage of a buffer off cache lines shared with other data.
+// Alignment must be a power of two not below alignof(T).
+template <class T, std::size_t Alignment>
+class AlignedAllocator {
+    static_assert((Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two");
+    static_assert(Alignment >= alignof(T), "Alignment must not be below alignof(T)");
+
+public:
+    typedef T value_type;
+    typedef std::true_type is_always_equal;
+
+    template <class U>
+    struct rebind {
+        typedef AlignedAllocator<U, Alignment> other;
+    };
+
+    AlignedAllocator() noexcept {}
+
+    template <class U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {}
+
+    // Allocates storage for n elements aligned to Alignment bytes
+    T* allocate(std::size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+    }
+
+    // Releases storage obtained from allocate
+    void deallocate(T* p, std::size_t) noexcept {
+        ::operator delete(p, std::align_val_t(Alignment));
+    }
+
+    friend bool operator==(const AlignedAllocator&, const AlignedAllocator&) { return true; }
+    friend bool operator!=(const AlignedAllocator&, const AlignedAllocator&) { return false; }
+};
@@ -0,0 +1,242 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <utility>
+
+#include "wait-word.h"
+
+// Adds blocking push_wait/pop_wait and their timed variants to a lock-free
+// queue with try_push/try_pop, such as SpscCircularBuffer or
+// MpmcCircularBuffer. A waiting thread first spins on the queue for an
+// adaptive number of attempts, then parks on a WaitWord. The other side
+// only makes a wake-up syscall when someone is actually parked.
+template <class Queue>
+class BlockingCircularBuffer {
+public:
+    typedef typename Queue::value_type value_type;
+    typedef std::chrono::steady_clock clock;
+
+private:
+    static constexpr int cache_line = 64;
+    static constexpr int min_spin = 1;
+    static constexpr int max_spin = 4096;
+
+    Queue ring;   // Underlying lock-free queue
+
+    // Consumers park here until an element arrives
+    alignas(cache_line) WaitWord not_empty;
+    std::atomic<int> consumers_waiting;
+    std::atomic<int> pop_spin;
+
+    // Producers park here until a slot frees up
+    alignas(cache_line) WaitWord not_full;
+    std::atomic<int> producers_waiting;
+    std::atomic<int> push_spin;
+
+    // Pause hint for spin loops
+    static void relax();
+
+    // Wakes one parked thread of the other side, if there is one
+    static void wake(WaitWord& word, std::atomic<int>& waiters);
+
+    // Retries op until it succeeds, spinning first and then parking on word
+    // Gives up once deadline (if not null) has passed; returns the last result of op
+    template <class Op>
+    static bool wait_for(Op op, WaitWord& word, std::atomic<int>& waiters, std::atomic<int>& spin,
+                         const clock::time_point* deadline);
+
+public:
+    // Constructs the underlying queue from the given arguments
+    template <class... Args>
+    explicit BlockingCircularBuffer(Args&&... args);
+
+    BlockingCircularBuffer(const BlockingCircularBuffer&) = delete;
+    BlockingCircularBuffer& operator=(const BlockingCircularBuffer&) = delete;
+
+    // Adds an element to the end of the queue without waiting
+    // Returns false if the queue is full
+    bool try_push(const value_type& item);
+
+    // Removes the first element of the queue into item without waiting
+    // Returns false if the queue is empty
+    bool try_pop(value_type& item);
+
+    // Adds an element to the end of the queue, waiting for a free slot
+    void push_wait(const value_type& item);
+
+    // Removes the first element of the queue into item, waiting for one to arrive
+    void pop_wait(value_type& item);
+
+    // Same as push_wait, but gives up after timeout or at deadline
+    // Returns false if the element was not added
+    template <class Rep, class Period>
+    bool push_wait_for(const value_type& item, const std::chrono::duration<Rep, Period>& timeout);
+    bool push_wait_until(const value_type& item, clock::time_point deadline);
+
+    // Same as pop_wait, but gives up after timeout or at deadline
+    // Returns false if no element was removed
+    template <class Rep, class Period>
+    bool pop_wait_for(value_type& item, const std::chrono::duration<Rep, Period>& timeout);
+    bool pop_wait_until(value_type& item, clock::time_point deadline);
+
+    // Returns the number of stored elements; exact only when all threads are idle
+    int size() const;
+
+    // Checks if the queue is empty
+    bool empty() const;
+
+    // Returns the capacity of the queue
+    int capacity() const;
+};
+
+// Pause hint for spin loops
+template <class Queue>
+void BlockingCircularBuffer<Queue>::relax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#else
+    std::this_thread::yield();
+#endif
+}
+
+// Constructs the underlying queue from the given arguments
+template <class Queue>
+template <class... Args>
+BlockingCircularBuffer<Queue>::BlockingCircularBuffer(Args &&...args)
+    : ring(std::forward<Args>(args)...), consumers_waiting(0), pop_spin(64),
+      producers_waiting(0), push_spin(64) {}
+
+// Wakes one parked thread of the other side, if there is one
+template <class Queue>
+void BlockingCircularBuffer<Queue>::wake(WaitWord &word, std::atomic<int> &waiters) {
+    // Pairs with the fence in wait_for: either the waiter sees our change to
+    // the queue or we see its registration
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiters.load(std::memory_order_relaxed) > 0) {
+        word.notify(1);
+    }
+}
+
+// Retries op until it succeeds, spinning first and then parking on word
+// Gives up once deadline (if not null) has passed; returns the last result of op
+template <class Queue>
+template <class Op>
+bool BlockingCircularBuffer<Queue>::wait_for(Op op, WaitWord &word, std::atomic<int> &waiters,
+                                             std::atomic<int> &spin, const clock::time_point *deadline) {
+    int limit = spin.load(std::memory_order_relaxed);
+    for (int i = 0; i < limit; ++i) {
+        if (op()) {
+            // Spinning paid off, allow a little more next time
+            spin.store(std::min(max_spin, limit * 2), std::memory_order_relaxed);
+            return true;
+        }
+        relax();
+    }
+    spin.store(std::max(min_spin, limit / 2), std::memory_order_relaxed);
+
+    for (;;) {
+        std::uint32_t seen = word.load();
+        waiters.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        bool done = op();
+        bool in_time = true;
+        if (!done) {
+            if (deadline) {
+                in_time = word.wait_until(seen, *deadline);
+            } else {
+                word.wait(seen);
+            }
+        }
+        waiters.fetch_sub(1, std::memory_order_relaxed);
+        if (done) {
+            return true;
+        }
+        if (!in_time) {
+            // A wake-up may have been aimed at us just as the deadline passed
+            return op();
+        }
+    }
+}
+
+// Adds an element to the end of the queue without waiting
+// Returns false if the queue is full
+template <class Queue>
+bool BlockingCircularBuffer<Queue>::try_push(const value_type &item) {
+    if (!ring.try_push(item)) {
+        return false;
+    }
+    wake(not_empty, consumers_waiting);
+    return true;
+}
+
+// Removes the first element of the queue into item without waiting
+// Returns false if the queue is empty
+template <class Queue>
+bool BlockingCircularBuffer<Queue>::try_pop(value_type &item) {
+    if (!ring.try_pop(item)) {
+        return false;
+    }
+    wake(not_full, producers_waiting);
+    return true;
+}
+
+// Adds an element to the end of the queue, waiting for a free slot
+template <class Queue>
+void BlockingCircularBuffer<Queue>::push_wait(const value_type &item) {
+    wait_for([&] { return try_push(item); }, not_full, producers_waiting, push_spin, nullptr);
+}
+
+// Removes the first element of the queue into item, waiting for one to arrive
+template <class Queue>
+void BlockingCircularBuffer<Queue>::pop_wait(value_type &item) {
+    wait_for([&] { return try_pop(item); }, not_empty, consumers_waiting, pop_spin, nullptr);
+}
+
+// Same as push_wait, but gives up after timeout or at deadline
+// Returns false if the element was not added
+template <class Queue>
+template <class Rep, class Period>
+bool BlockingCircularBuffer<Queue>::push_wait_for(const value_type &item,
+                                                  const std::chrono::duration<Rep, Period> &timeout) {
+    return push_wait_until(item, clock::now() + std::chrono::duration_cast<clock::duration>(timeout));
+}
+
+template <class Queue>
+bool BlockingCircularBuffer<Queue>::push_wait_until(const value_type &item, clock::time_point deadline) {
+    return wait_for([&] { return try_push(item); }, not_full, producers_waiting, push_spin, &deadline);
+}
+
+// Same as pop_wait, but gives up after timeout or at deadline
+// Returns false if no element was removed
+template <class Queue>
+template <class Rep, class Period>
+bool BlockingCircularBuffer<Queue>::pop_wait_for(value_type &item,
+                                                 const std::chrono::duration<Rep, Period> &timeout) {
+    return pop_wait_until(item, clock::now() + std::chrono::duration_cast<clock::duration>(timeout));
+}
+
+template <class Queue>
+bool BlockingCircularBuffer<Queue>::pop_wait_until(value_type &item, clock::time_point deadline) {
+    return wait_for([&] { return try_pop(item); }, not_empty, consumers_waiting, pop_spin, &deadline);
+}
+
+// Returns the number of stored elements; exact only when all threads are idle
+template <class Queue>
+int BlockingCircularBuffer<Queue>::size() const {
+    return ring.size();
+}
+
+// Checks if the queue is empty
+template <class Queue>
+bool BlockingCircularBuffer<Queue>::empty() const {
+    return ring.empty();
+}
+
+// Returns the capacity of the queue
+template <class Queue>
+int BlockingCircularBuffer<Queue>::capacity() const {
+    return ring.capacity();
+}
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// Point-in-time copy of the counters of a BufferStats
+struct BufferStatsSnapshot {
+    static constexpr int histogram_buckets = 8;
+
+    int capacity = 0;                      // Capacity of the observed buffer
+    std::uint64_t pushes = 0;              // Elements added
+    std::uint64_t pops = 0;                // Elements removed, including by clear()
+    std::uint64_t overwrites = 0;          // Elements overwritten by a push into a full buffer
+    int high_water = 0;                    // Largest size seen
+    // Occupancy sampled after every push and pop: bucket i counts samples with
+    // size in [i, i + 1) * capacity / histogram_buckets, the last one includes full
+    std::array<std::uint64_t, histogram_buckets> occupancy = {};
+    std::chrono::nanoseconds time_at_full{0};   // Total time the buffer spent full
+
+    // Returns the counters as "name value" lines
+    std::string to_text() const;
+
+    // Returns the counters as a single-line JSON object
+    std::string to_json() const;
+};
+
+// Counters of a buffer that is modified by one thread at a time.
+// The owning thread updates them with relaxed loads and stores, which cost
+// as much as plain memory accesses; any other thread may take a snapshot()
+// at any moment and sees each counter torn-free, if slightly stale.
+// The clock is read only when the buffer becomes full or stops being full.
+class BufferStats {
+private:
+    typedef std::chrono::steady_clock clock;
+
+    int cap;                                        // Capacity of the observed buffer
+    int bucket;                                     // Occupancy bucket of the current size
+    // Smallest size of each occupancy bucket, then an end marker above cap
+    int bounds[BufferStatsSnapshot::histogram_buckets + 1];
+    std::atomic<std::uint64_t> pushes;              // Elements added
+    std::atomic<std::uint64_t> pops;                // Elements removed
+    std::atomic<std::uint64_t> overwrites;          // Elements overwritten
+    std::atomic<int> high_water;                    // Largest size seen
+    std::atomic<std::uint64_t> occupancy[BufferStatsSnapshot::histogram_buckets];
+    std::atomic<std::int64_t> full_since;           // Clock ticks when the buffer became full, -1 if not full
+    std::atomic<std::int64_t> full_ticks;           // Clock ticks spent full before full_since
+
+    // Adds n to a counter written only by the owning thread
+    template <class Int>
+    static void bump(std::atomic<Int>& counter, Int n);
+
+    // Records the size after an operation
+    void sample(int size);
+
+public:
+    // Constructs zeroed counters for a buffer of the given capacity
+    explicit BufferStats(int capacity = 0);
+
+    BufferStats(const BufferStats&) = delete;
+    BufferStats& operator=(const BufferStats&) = delete;
+
+    // Records n elements added, overwritten of which replaced stored ones, leaving size elements
+    void on_push(int n, int overwritten, int size);
+
+    // Records n elements removed, leaving size elements
+    void on_pop(int n, int size);
+
+    // Returns a copy of the counters; safe to call from any thread
+    BufferStatsSnapshot snapshot() const;
+
+    // Zeroes the counters, keeping the current fullness; only from the owning thread
+    void reset(int size);
+};
+
+// Stand-in for BufferStats that records nothing and compiles away
+class NullBufferStats {
+public:
+    explicit NullBufferStats(int = 0) {}
+
+    void on_push(int, int, int) {}
+
+    void on_pop(int, int) {}
+
+    BufferStatsSnapshot snapshot() const { return BufferStatsSnapshot(); }
+
+    void reset(int) {}
+};
+
+// Statistics used by InstrumentedCircularBuffer unless told otherwise;
+// building with CIRCULAR_BUFFER_NO_STATS turns them off everywhere
+#ifdef CIRCULAR_BUFFER_NO_STATS
+typedef NullBufferStats DefaultBufferStats;
+#else
+typedef BufferStats DefaultBufferStats;
+#endif
+
+// Adds n to a counter written only by the owning thread
+template <class Int>
+inline void BufferStats::bump(std::atomic<Int> &counter, Int n) {
+    counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+// Records the size after an operation
+// Walks from the bucket of the previous size instead of dividing, which is
+// one or two compares for single-element operations
+inline void BufferStats::sample(int size) {
+    while (size >= bounds[bucket + 1]) {
+        ++bucket;
+    }
+    while (size < bounds[bucket]) {
+        --bucket;
+    }
+    bump(occupancy[bucket], std::uint64_t(1));
+}
+
+// Records n elements added, overwritten of which replaced stored ones, leaving size elements
+inline void BufferStats::on_push(int n, int overwritten, int size) {
+    bump(pushes, static_cast<std::uint64_t>(n));
+    if (overwritten > 0) {
+        bump(overwrites, static_cast<std::uint64_t>(overwritten));
+    }
+    if (size > high_water.load(std::memory_order_relaxed)) {
+        high_water.store(size, std::memory_order_relaxed);
+    }
+    if (size == cap && full_since.load(std::memory_order_relaxed) < 0) {
+        full_since.store(clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+    }
+    sample(size);
+}
+
+// Records n elements removed, leaving size elements
+inline void BufferStats::on_pop(int n, int size) {
+    bump(pops, static_cast<std::uint64_t>(n));
+    std::int64_t since = full_since.load(std::memory_order_relaxed);
+    if (since >= 0 && size < cap) {
+        bump(full_ticks, clock::now().time_since_epoch().count() - since);
+        full_since.store(-1, std::memory_order_relaxed);
+    }
+    sample(size);
+}
@@ -1,38 +1,248 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
 #include <iostream>
+#include <memory>
+#include <memory_resource>
 #include <stdexcept>
+#include <cstddef>
 #include <cstring>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#include "simd-scan.h"
+
+// Random-access iterator over the elements of a CircularBuffer in logical order.
+// Keeps the physical position of the first element and wraps with a
+// compare instead of a division. Invalidated by any operation that moves
+// the first element (push_front, pop_front, overwrite, linearize, ...).
+template <class T, bool Const>
+class CircularBufferIterator {
+public:
+    typedef std::random_access_iterator_tag iterator_category;
+    typedef typename std::remove_const<T>::type value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef typename std::conditional<Const, const T*, T*>::type pointer;
+    typedef typename std::conditional<Const, const T&, T&>::type reference;
+
+private:
+    pointer buffer;    // Storage of the buffer
+    int cap;           // Capacity of the buffer
+    int start;         // Physical index of the first element
+    int pos;           // Logical index of the element
+
+    template <class, class>
+    friend class CircularBuffer;
+    template <class, int>
+    friend class StaticCircularBuffer;
+    template <class, bool>
+    friend class CircularBufferIterator;
+
+    CircularBufferIterator(pointer buffer, int cap, int start, int pos)
+        : buffer(buffer), cap(cap), start(start), pos(pos) {}
+
+public:
+    CircularBufferIterator() : buffer(nullptr), cap(0), start(0), pos(0) {}
+
+    // Converts an iterator to a const_iterator
+    template <bool WasConst, class = typename std::enable_if<Const && !WasConst>::type>
+    CircularBufferIterator(const CircularBufferIterator<T, WasConst>& it)
+        : buffer(it.buffer), cap(it.cap), start(it.start), pos(it.pos) {}
+
+    reference operator*() const {
+        int i = start + pos;
+        return buffer[i >= cap ? i - cap : i];
+    }
+    pointer operator->() const { return &**this; }
+    reference operator[](difference_type n) const { return *(*this + n); }
+
+    CircularBufferIterator& operator++() { ++pos; return *this; }
+    CircularBufferIterator operator++(int) { CircularBufferIterator it(*this); ++pos; return it; }
+    CircularBufferIterator& operator--() { --pos; return *this; }
+    CircularBufferIterator operator--(int) { CircularBufferIterator it(*this); --pos; return it; }
+    CircularBufferIterator& operator+=(difference_type n) { pos += static_cast<int>(n); return *this; }
+    CircularBufferIterator& operator-=(difference_type n) { pos -= static_cast<int>(n); return *this; }
+
+    friend CircularBufferIterator operator+(CircularBufferIterator it, difference_type n) { return it += n; }
+    friend CircularBufferIterator operator+(difference_type n, CircularBufferIterator it) { return it += n; }
+    friend CircularBufferIterator operator-(CircularBufferIterator it, difference_type n) { return it -= n; }
+    friend difference_type operator-(const CircularBufferIterator& a, const CircularBufferIterator& b) {
+        return a.pos - b.pos;
+    }
+
+    friend bool operator==(const CircularBufferIterator& a, const CircularBufferIterator& b) { return a.pos == b.pos; }
+    friend bool operator!=(const CircularBufferIterator& a, const CircularBufferIterator& b) { return a.pos != b.pos; }
+    friend bool operator<(const CircularBufferIterator& a, const CircularBufferIterator& b) { return a.pos < b.pos; }
+    friend bool operator>(const CircularBufferIterator& a, const CircularBufferIterator& b) { return a.pos > b.pos; }
+    friend bool operator<=(const CircularBufferIterator& a, const CircularBufferIterator& b) { return a.pos <= b.pos; }
+    friend bool operator>=(const CircularBufferIterator& a, const CircularBufferIterator& b) { return a.pos >= b.pos; }
+};
 
-typedef char value_type;
+// Helpers shared by the buffers in this library, not part of the public interface
+namespace detail {
 
+// Hands the contiguous run [first, first + n) to a batch consumer: whole, as
+// f(first, first + n), if f accepts two pointers, otherwise one element at a time
+template <class Pointer, class F>
+void consume_run(Pointer first, std::size_t n, F& f) {
+    if constexpr (std::is_invocable<F&, Pointer, Pointer>::value) {
+        if (n > 0) {
+            f(first, first + n);
+        }
+    } else {
+        for (std::size_t i = 0; i < n; ++i) {
+            f(first[i]);
+        }
+    }
+}
+
+}  // namespace detail
+
+template <class T = char, class Allocator = std::allocator<T>>
 class CircularBuffer {
+public:
+    typedef T value_type;
+    typedef Allocator allocator_type;
+    typedef value_type& reference;
+    typedef const value_type& const_reference;
+    typedef value_type* pointer;
+    typedef const value_type* const_pointer;
+
+    // Contiguous span of the storage
+    struct region {
+        pointer data;
+        int size;
+    };
+
+    struct const_region {
+        const_pointer data;
+        int size;
+    };
+
+    typedef CircularBufferIterator<T, false> iterator;
+    typedef CircularBufferIterator<T, true> const_iterator;
+    typedef std::reverse_iterator<iterator> reverse_iterator;
+    typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
 private:
-    value_type* buffer;    // Pointer to the buffer array
+    typedef std::allocator_traits<Allocator> alloc_traits;
+
+    Allocator alloc;       // Allocator used for the storage and the elements
+    pointer buffer;        // Pointer to the buffer array, only [start, start + count) is constructed
     int cap;               // Capacity of the buffer
     int start;             // Index of the first element
-    int end;               // Index of the last element
+    int finish;            // Index one past the last element
     int count;             // Number of elements in the buffer
 
-    // Helper function to calculate the actual index in the buffer array
+    // Helper function to calculate the actual index in the buffer array, 0 <= i <= cap
+    // Wraps with a compare instead of a division
     int index(int i) const {
-        return (start + i) % cap;
+        int j = start + i;
+        return j >= cap ? j - cap : j;
     }
 
+    // Physical index following and preceding physical index i
+    int next(int i) const {
+        return i + 1 == cap ? 0 : i + 1;
+    }
+
+    int prev(int i) const {
+        return i == 0 ? cap - 1 : i - 1;
+    }
+
+    // Allocates raw storage for n elements, nullptr for n == 0
+    pointer allocate(int n);
+
+    // Destroys all stored elements and releases the storage
+    void release();
+
+    // Copies n elements into the storage starting at physical index pos,
+    // splitting the copy at the end of the array
+    // Only used for trivially copyable types
+    void copy_in(int pos, const value_type* data, int n);
+
+    // Copies n elements out of the storage starting at physical index pos
+    // Only used for trivially copyable types
+    void copy_out(int pos, value_type* out, int n) const;
+
+    // Physical index of logical position i, which may lie in [-cap, 2 * cap)
+    int wrap(int i) const {
+        int j = (start + i) % cap;
+        return j < 0 ? j + cap : j;
+    }
+
+    // Moves n elements from logical [from, from + n) to logical [to, to + n)
+    // Positions outside [0, size()) are raw storage; trivially copyable types
+    // are moved with at most three memmoves
+    void shift(int from, int to, int n);
+
+    // Opens k slots before element pos by moving the shorter side outward
+    // Returns the range of new slots, relative to pos, that are raw storage;
+    // the others hold moved-from elements
+    std::pair<int, int> open_gap(int pos, int k);
+
+    // Moves n elements from physical [from, from + n) down to [to, to + n), to < from
+    // The slots [to, from) must be raw storage; vacated slots are destroyed
+    void relocate_down(int from, int to, int n);
+
+    // Rotates [first, last) so that mid becomes first, copying whole blocks
+    // Only used for trivially copyable types
+    static void rotate_blocks(pointer first, pointer mid, pointer last);
+
+    // Takes over the storage of cb, leaving it empty with zero capacity
+    void steal(CircularBuffer& cb);
+
+    // Element types scanned with the byte kernels of simd-scan.h
+    static constexpr bool byte_elements = std::is_integral<T>::value && sizeof(T) == 1;
+
+    // Returns up to two spans holding the elements from position pos on, in order
+    std::array<const_region, 2> regions_from(int pos) const;
+
+    // Stores item after the last element, overwriting the first element if full
+    template <class U>
+    void store_back(U&& item);
+
+    // Stores item before the first element, overwriting the last element if full
+    template <class U>
+    void store_front(U&& item);
+
 public:
     // Default constructor
     CircularBuffer();
 
+    // Constructs an empty buffer that will allocate from allocator
+    explicit CircularBuffer(const allocator_type& allocator);
+
     // Destructor
     ~CircularBuffer();
 
     // Copy constructor
     CircularBuffer(const CircularBuffer& cb);
 
+    // Copy constructor allocating from allocator
+    CircularBuffer(const CircularBuffer& cb, const allocator_type& allocator);
+
+    // Move constructor, takes over the storage of cb in O(1)
+    CircularBuffer(CircularBuffer&& cb) noexcept;
+
+    // Move constructor allocating from allocator
+    // O(1) if allocator equals the allocator of cb, otherwise moves element by element
+    CircularBuffer(CircularBuffer&& cb, const allocator_type& allocator);
+
     // Constructs a buffer with a given capacity
     explicit CircularBuffer(int capacity);
 
+    // Constructs a buffer with a given capacity allocated from allocator
+    CircularBuffer(int capacity, const allocator_type& allocator);
+
     // Constructs a buffer with a given capacity and fills it with elem
     CircularBuffer(int capacity, const value_type& elem);
 
+    // Constructs a buffer with a given capacity allocated from allocator and fills it with elem
+    CircularBuffer(int capacity, const value_type& elem, const allocator_type& allocator);
+
     // Access by index without bounds checking
     value_type& operator[](int i);
     const value_type& operator[](int i) const;
@@ -50,12 +260,16 @@ public:
     const value_type& back() const;
 
     // Linearizes the buffer so that the first element is at the beginning of allocated memory
+    // Works in place and never allocates
     value_type* linearize();
 
     // Checks if the buffer is linearized
     bool is_linearized() const;
 
     // Rotates the buffer so that the element at new_begin becomes the first element
+    // O(1) for a full buffer. Otherwise trivially copyable elements are rotated
+    // with block copies into linearized order, and other types move
+    // min(new_begin, size() - new_begin) elements around the ring
     void rotate(int new_begin);
 
     // Returns the number of elements stored in the buffer
@@ -73,26 +287,62 @@ public:
     // Returns the capacity of the buffer
     int capacity() const;
 
+    // Returns a copy of the allocator
+    allocator_type get_allocator() const;
+
     // Sets a new capacity for the buffer
     void set_capacity(int new_capacity);
 
+    // Resizes the buffer
+    // If the buffer is expanded, new elements are value-initialized
+    void resize(int new_size);
+
     // Resizes the buffer
     // If the buffer is expanded, new elements are filled with item
-    void resize(int new_size, const value_type& item = value_type());
+    void resize(int new_size, const value_type& item);
 
     // Assignment operator
+    // Keeps the current allocator unless the allocator propagates on copy assignment
     CircularBuffer& operator=(const CircularBuffer& cb);
 
+    // Move assignment operator
+    // O(1) unless the allocators differ and do not propagate
+    CircularBuffer& operator=(CircularBuffer&& cb) noexcept(
+        std::allocator_traits<Allocator>::propagate_on_container_move_assignment::value ||
+        std::allocator_traits<Allocator>::is_always_equal::value);
+
     // Swaps the contents of the buffer with another buffer
+    // The allocators are swapped only if they propagate on swap, otherwise they must be equal
     void swap(CircularBuffer& cb);
 
     // Adds an element to the end of the buffer
     // If the buffer is full, the first element is overwritten
     void push_back(const value_type& item = value_type());
 
+    void push_back(value_type&& item);
+
     // Adds a new element before the first element of the buffer
     // If the buffer is full, the last element is overwritten
     void push_front(const value_type& item = value_type());
+    void push_front(value_type&& item);
+
+    // Constructs an element in place after the last element
+    // If the buffer is full, the first element is overwritten by a temporary built from args
+    template <class... Args>
+    value_type& emplace_back(Args&&... args);
+
+    // Constructs an element in place before the first element
+    // If the buffer is full, the last element is overwritten by a temporary built from args
+    template <class... Args>
+    value_type& emplace_front(Args&&... args);
+
+    // Adds n elements to the end of the buffer
+    // Equivalent to calling push_back for data[0], ..., data[n - 1]
+    void push_back(const value_type* data, int n);
+
+    // Adds n elements before the first element so that data[0] becomes the first one
+    // Equivalent to calling push_front for data[n - 1], ..., data[0]
+    void push_front(const value_type* data, int n);
 
     // Removes the last element of the buffer
     void pop_back();
@@ -100,18 +350,1429 @@ public:
     // Removes the first element of the buffer
     void pop_front();
 
+    // Removes the last n elements of the buffer and copies them in order into out
+    void pop_back(value_type* out, int n);
+
+    // Removes the first n elements of the buffer and copies them into out
+    void pop_front(value_type* out, int n);
+
     // Inserts an element at the specified position
-    // The capacity of the buffer remains unchanged
+    // Shifts whichever side of pos is shorter; the capacity of the buffer remains unchanged
     void insert(int pos, const value_type& item = value_type());
+    void insert(int pos, value_type&& item);
+
+    // Inserts the elements of [first, last) at the specified position with a single shift
+    // The capacity of the buffer remains unchanged
+    template <class ForwardIt, class = typename std::enable_if<std::is_base_of<
+        std::forward_iterator_tag, typename std::iterator_traits<ForwardIt>::iterator_category>::value>::type>
+    void insert(int pos, ForwardIt first, ForwardIt last);
+
+    // Constructs an element at the specified position
+    // Only an element appended at either end is built directly in its slot;
+    // otherwise a temporary is moved in after the shift
+    template <class... Args>
+    value_type& emplace(int pos, Args&&... args);
 
     // Erases elements in the range [first, last)
+    // Shifts whichever side of the range is shorter
     void erase(int first, int last);
 
     // Clears the buffer
     void clear();
+
+    // Returns up to two spans of free storage following the last element, in order
+    // Only for trivially copyable types; the spans stay valid until the next modification
+    std::array<region, 2> write_regions();
+
+    // Publishes the first n elements written into the spans from write_regions()
+    void commit_write(int n);
+
+    // Returns up to two spans holding the elements, in order
+    std::array<region, 2> read_regions();
+    std::array<const_region, 2> read_regions() const;
+
+    // Removes the first n elements of the buffer
+    void consume(int n);
+
+    // Returns the index of the first element equal to value at or after pos, -1 if there is none
+    // Byte elements are scanned with SIMD kernels, one call per contiguous span
+    int find(const value_type& value, int pos = 0) const;
+
+    // Returns the index of the first occurrence of seq[0, n) starting at or after pos, -1 if there is none
+    // Occurrences may wrap around the end of the storage
+    int find(const value_type* seq, int n, int pos = 0) const;
+
+    // Iterators over the elements in logical order
+    iterator begin();
+    iterator end();
+    const_iterator begin() const;
+    const_iterator end() const;
+    const_iterator cbegin() const;
+    const_iterator cend() const;
+    reverse_iterator rbegin();
+    reverse_iterator rend();
+    const_reverse_iterator rbegin() const;
+    const_reverse_iterator rend() const;
+    const_reverse_iterator crbegin() const;
+    const_reverse_iterator crend() const;
+
+    // Calls f(first, last) with raw pointer ranges for each of the (at most two)
+    // contiguous runs of elements, in order
+    template <class F>
+    void for_each_segment(F f);
+    template <class F>
+    void for_each_segment(F f) const;
+
+    // Calls f on the first min(n, size()) elements, then removes them with a single update of the head
+    // f takes either a contiguous run (pointer first, pointer last) or one element by reference;
+    // if f throws, no element is removed
+    // Returns the number of elements removed
+    template <class F>
+    int consume_up_to(int n, F f);
+
+    // Calls f on every element, then removes them all; see consume_up_to
+    template <class F>
+    int consume_all(F f);
 };
 
+// Deduces the element type from the fill value, as in CircularBuffer cb(3, 'a')
+template <class T>
+CircularBuffer(int, const T&) -> CircularBuffer<T>;
+
+// CircularBuffer drawing its storage from a std::pmr::memory_resource,
+// so that many short-lived buffers can share a pool or an arena
+template <class T = char>
+using PmrCircularBuffer = CircularBuffer<T, std::pmr::polymorphic_allocator<T>>;
+
+// Segment-aware algorithms: each runs the std algorithm on raw pointer ranges
+
+// Copies the elements in order to out
+template <class T, class Allocator, class OutputIt>
+OutputIt segmented_copy(const CircularBuffer<T, Allocator>& cb, OutputIt out);
+
+// Assigns value to every element
+template <class T, class Allocator>
+void segmented_fill(CircularBuffer<T, Allocator>& cb, const T& value);
+
+// Returns an iterator to the first element equal to value, or end()
+template <class T, class Allocator>
+typename CircularBuffer<T, Allocator>::const_iterator
+segmented_find(const CircularBuffer<T, Allocator>& cb, const T& value);
+
+// Returns the number of elements equal to value
+template <class T, class Allocator>
+int segmented_count(const CircularBuffer<T, Allocator>& cb, const T& value);
+
+// Equality operators
+// Compare the contiguous spans of both buffers pairwise, with memcmp for
+// integral and enum types, whose bytes alone decide equality
+template <class T, class Allocator>
+bool operator==(const CircularBuffer<T, Allocator>& a, const CircularBuffer<T, Allocator>& b);
+template <class T, class Allocator>
+bool operator!=(const CircularBuffer<T, Allocator>& a, const CircularBuffer<T, Allocator>& b);
+
+// Allocates raw storage for n elements, nullptr for n == 0
+template <class T, class Allocator>
+typename CircularBuffer<T, Allocator>::pointer CircularBuffer<T, Allocator>::allocate(int n) {
+    return n == 0 ? nullptr : alloc_traits::allocate(alloc, n);
+}
+
+// Destroys all stored elements and releases the storage
+template <class T, class Allocator>
+void CircularBuffer<T, Allocator>::release() {
+    clear();
+    if (buffer) {
+        alloc_traits::deallocate(alloc, buffer, cap);
+    }
+    buffer = nullptr;
+}
+
+// Copies n elements into the storage starting at physical index pos,
+// splitting the copy at the end of the array
+// Only used for trivially copyable types
+template <class T, class Allocator>
+void CircularBuffer<T, Allocator>::copy_in(int pos, const value_type *data, int n) {
+    static_assert(std::is_trivially_copyable<value_type>::value, "copy_in requires a trivially copyable value_type");
+    int first = std::min(n, cap - pos);
+    std::memcpy(buffer + pos, data, first * sizeof(value_type));
+    std::memcpy(buffer, data + first, (n - first) * sizeof(value_type));
+}
+
+// Copies n elements out of the storage starting at physical index pos
+// Only used for trivially copyable types
+template <class T, class Allocator>
+void CircularBuffer<T, Allocator>::copy_out(int pos, value_type *out, int n) const {
+    static_assert(std::is_trivially_copyable<value_type>::value, "copy_out requires a trivially copyable value_type");
+    int first = std::min(n, cap - pos);
+    std::memcpy(out, buffer + pos, first * sizeof(value_type));
+    std::memcpy(out + first, buffer, (n - first) * sizeof(value_type));
+}
+
+// Takes over the storage of cb, leaving it empty with zero capacity
+template <class T, class Allocator>
+void CircularBuffer<T, Allocator>::steal(CircularBuffer &cb) {
+    buffer = cb.buffer;
+    cap = cb.cap;
+    start = cb.start;
+    finish = cb.finish;
+    count = cb.count;
+    cb.buffer = nullptr;
+    cb.cap = 0;
+    cb.start = 0;
+    cb.finish = 0;
+    cb.count = 0;
+}
+
+// Stores item after the last element, overwriting the first element if full
+template <class T, class Allocator>
+template <class U>
+void CircularBuffer<T, Allocator>::store_back(U &&item) {
+    if (cap == 0) {
+        throw std::runtime_error("Buffer capacity is zero");
+    }
+    if (full()) {
+        buffer[finish] = std::forward<U>(item);
+        finish = next(finish);
+        start = finish;
+    } else {
+        alloc_traits::construct(alloc, buffer + finish, std::forward<U>(item));
+        finish = next(finish);
+        ++count;
+    }
+}
+
+// Stores item before the first element, overwriting the last element if full
+template <class T, class Allocator>
+template <class U>
+void CircularBuffer<T, Allocator>::store_front(U &&item) {
+    if (cap == 0) {
+        throw std::runtime_error("Buffer capacity is zero");
+    }
+    int new_start = prev(start);
+    if (full()) {
+        buffer[new_start] = std::forward<U>(item);
+        finish = new_start;
+    } else {
+        alloc_traits::construct(alloc, buffer + new_start, std::forward<U>(item));
+        ++count;
+    }
+    start = new_start;
+}
+
+// Moves n elements from logical [from, from + n) to logical [to, to + n)
+// Positions outside [0, size()) are raw storage; trivially copyable types
+// are moved with at most three memmoves
+template <class T, class Allocator>
+void CircularBuffer<T, Allocator>::shift(int from, int to, int n) {
+    if (n <= 0 || from == to) {
+        return;
+    }
+    if constexpr (std::is_trivially_copyable<value_type>::value) {
+        // Each chunk stops at the end of the array on either side
+        if (to < from) {
+            for (int done = 0; done < n;) {
+                int src = wrap(from + done);
+                int dst = wrap(to + done);
+                int len = std::min(n - done, std::min(cap - src, cap - dst));
+                std::memmove(buffer + dst, buffer + src, len * sizeof(value_type));
+                done += len;
+            }
+        } else {
+            for (int done = 0; done < n;) {
+                int src_end = wrap(from + n - done - 1) + 1;
+                int dst_end = wrap(to + n - done - 1) + 1;
+                int len = std::min(n - done, std::min(src_end, dst_end));
+                std::memmove(buffer + dst_end - len, buffer + src_end - len, len * sizeof(value_type));
+                done += len;
+            }
+        }
+    } else {
+        auto move_one = [this](int src, int dst) {
+            pointer target = buffer + wrap(dst);
+            if (dst < 0 || dst >= count) {
+                alloc_traits::construct(alloc, target, std::move(buffer[wrap(src)]));
+            } else {
+                *target = std::move(buffer[wrap(src)]);
+            }
+        };
+        if (to < from) {
+            for (int i = 0; i < n; ++i) {
+                move_one(from + i, to + i);
+            }
+        } else {
+            for (int i = n - 1; i >= 0; --i) {
+                move_one(from + i, to + i);
+            }
+        }
+    }
+}
+
+// Opens k slots before element pos by moving the shorter side outward
+// Returns the range of new slots, relative to pos, that are raw storage;
+// the others hold moved-from elements
+template <class T, class Allocator>
+std::pair<int, int> CircularBuffer<T, Allocator>::open_gap(int pos, int k) {
+    std::pair<int, int> raw;
+    if (pos < count - pos) {
+        // Move the front part k slots towards the front
+        shift(0, -k, pos);
+        start = wrap(-k);
+        raw = std::make_pair(0, std::max(0, k - pos));
+    } else {
+        shift(pos, pos + k, count - pos);
+        raw = std::make_pair(std::min(k, count - pos), k);
+    }
+    count += k;
+    finish = (start + count) % cap;
+    return raw;
+}
+
+// Moves n elements from physical [from, from + n) down to [to, to + n), to < from
+// The slots [to, from) must be raw storage; vacated slots are destroyed
+template <class T, class Allocator>
+void CircularBuffer<T, Allocator>::relocate_down(int from, int to, int n) {
+    if constexpr (std::is_trivially_copyable<value_type>::value) {
+        std::memmove(buffer + to, buffer + from, n * sizeof(value_type));
+    } else {
+        for (int i = 0; i < n; ++i) {
+            if (to + i < from) {
+                alloc_traits::construct(alloc, buffer + to + i, std::move(buffer[from + i]));
+            } else {
+                buffer[to + i] = std::move(buffer[from + i]);
+            }
+        }
+        for (int i = std::max(to + n, from); i < from + n; ++i) {
+            alloc_traits::destroy(alloc, buffer + i);
+        }
+    }
+}
+
+// Rotates [first, last) so that mid becomes first, copying whole blocks
+// Only used for trivially copyable types
+template <class T, class Allocator>
+void CircularBuffer<T, Allocator>::rotate_blocks(pointer first, pointer mid, pointer last) {
+    // Short sides go through a small stack buffer; otherwise the
+    // Gries-Mills block swap puts min(a, b) elements in place per step
+    const std::size_t scratch_bytes = 1024;
+    const std::ptrdiff_t scratch_size = std::max<std::ptrdiff_t>(1, scratch_bytes / sizeof(value_type));
+    alignas(value_type) unsigned char scratch_storage[scratch_bytes > sizeof(value_type) ? scratch_bytes : sizeof(value_type)];
+    pointer scratch = reinterpret_cast<pointer>(scratch_storage);
+
+    std::ptrdiff_t a = mid - first;
+    std::ptrdiff_t b = last - mid;
+    while (a != 0 && b != 0) {
+        if (a <= scratch_size) {
+            std::memcpy(scratch, first, a * sizeof(value_type));
+            std::memmove(first, mid, b * sizeof(value_type));
+            std::memcpy(first + b, scratch, a * sizeof(value_type));
+            return;
+        }
+        if (b <= scratch_size) {
+            std::memcpy(scratch, mid, b * sizeof(value_type));
+            std::memmove(first + b, first, a * sizeof(value_type));
+            std::memcpy(first, scratch, b * sizeof(value_type));
+            return;
+        }
+        if (a <= b) {
+            // A Bl Br -> Br Bl A, then rotate Br Bl
+            std::swap_ranges(first, mid, last - a);
+            last -= a;
+            b -= a;
+        } else {
+            // Al Ar B -> B Ar Al, then rotate Ar Al
+            std::swap_ranges(first, first + b, mid);
+            first += b;
+            a -= b;
+        }
+    }
+}
+
+// Default constructor
+template <class T, class Allocator>
+CircularBuffer<T, Allocator>::CircularBuffer()
+    : buffer(nullptr), cap(0), start(0), finish(0), count(0) {}
+
+// Constructs an empty buffer that will allocate from allocator
+template <class T, class Allocator>
+CircularBuffer<T, Allocator>::CircularBuffer(const allocator_type &allocator)
+    : alloc(allocator), buffer(nullptr), cap(0), start(0), finish(0), count(0) {}
+
+// Destructor
+template <class T, class Allocator>
+CircularBuffer<T, Allocator>::~CircularBuffer() {
+    release();
+}
+
+// Copy constructor
+template <class T, class Allocator>
+CircularBuffer<T, Allocator>::CircularBuffer(const CircularBuffer &cb)
+    : CircularBuffer(cb, alloc_traits::select_on_container_copy_construction(cb.alloc)) {}
+
+// Copy constructor allocating from allocator
+template <class T, class Allocator>
+CircularBuffer<T, Allocator>::CircularBuffer(const CircularBuffer &cb, const allocator_type &allocator)
+    : alloc(allocator), buffer(nullptr), cap(cb.cap), start(cb.start), finish(cb.finish), count(0) {
+    buffer = allocate(cap);
+    try {
+        for (; count < cb.count; ++count) {
+            alloc_traits::construct(alloc, buffer + index(count), cb.buffer[cb.index(count)]);
+        }
+    } catch (...) {
+        release();
+        throw;
+    }
+}
+
+// Move constructor, takes over the storage of cb in O(1)
+template <class T, class Allocator>
+CircularBuffer<T, Allocator>::CircularBuffer(CircularBuffer &&cb) noexcept
+    : alloc(std::move(cb.alloc)), buffer(nullptr), cap(0), start(0), finish(0), count(0) {
+    steal(cb);
+}
+
+// Move constructor allocating from allocator
+// O(1) if allocator equals the allocator of cb, otherwise moves element by element
+template <class T, class Allocator>
+CircularBuffer<T, Allocator>::CircularBuffer(CircularBuffer &&cb, const allocator_type &allocator)
+    : alloc(allocator), buffer(nullptr), cap(0), start(0), finish(0), count(0) {
+    if (alloc == cb.alloc) {
+        steal(cb);
+        return;
+    }
+    buffer = allocate(cb.cap);
+    cap = cb.cap;
+    try {
+        for (; count < cb.count; ++count) {
+            alloc_traits::construct(alloc, buffer + count, std::move(cb[count]));
+        }
+    } catch (...) {
+        release();
+        throw;
+    }
+    finish = cap == 0 ? 0 : count % cap;
+    cb.clear();
+}
+
+// Constructs a buffer with a given capacity
+template <class T, class Allocator>
+CircularBuffer<T, Allocator>::CircularBuffer(int capacity)
+    : CircularBuffer(capacity, allocator_type()) {}
+
+// Constructs a buffer with a given capacity allocated from allocator
+template <class T, class Allocator>
+CircularBuffer<T, Allocator>::CircularBuffer(int capacity, const allocator_type &allocator)
+    : alloc(allocator), buffer(nullptr), cap(capacity), start(0), finish(0), count(0) {
+    if (capacity < 0) {
+        throw std::invalid_argument("Capacity must be non-negative");
+    }
+    buffer = allocate(cap);
+}
+
+// Constructs a buffer with a given capacity and fills it with elem
+template <class T, class Allocator>
+CircularBuffer<T, Allocator>::CircularBuffer(int capacity, const value_type &elem)
+    : CircularBuffer(capacity, elem, allocator_type()) {}
+
+// Constructs a buffer with a given capacity allocated from allocator and fills it with elem
+template <class T, class Allocator>
+CircularBuffer<T, Allocator>::CircularBuffer(int capacity, const value_type &elem, const allocator_type &allocator)
+    : alloc(allocator), buffer(nullptr), cap(capacity), start(0), finish(0), count(0) {
+    if (capacity < 0) {
+        throw std::invalid_argument("Capacity must be non-negative");
+    }
+    buffer = allocate(cap);
+    try {
+        for (; count < cap; ++count) {
+            alloc_traits::construct(alloc, buffer + count, elem);
+        }
+    } catch (...) {
+        release();
+        throw;
+    }
+}
+
+// Access by index without bounds checking
+template <class T, class Allocator>
+T &CircularBuffer<T, Allocator>::operator[](int i) {
+    return buffer[index(i)];
+}
+
+template <class T, class Allocator>
+const T &CircularBuffer<T, Allocator>::operator[](int i) const {
+    return buffer[index(i)];
+}
+
+// Access by index with bounds checking
+template <class T, class Allocator>
+T &CircularBuffer<T, Allocator>::at(int i) {
+    if (i < 0 || i >= count) {
+        throw std::out_of_range("Index out of range");
+    }
+    return buffer[index(i)];
+}
+
+template <class T, class Allocator>
+const T &CircularBuffer<T, Allocator>::at(int i) const {
+    if (i < 0 || i >= count) {
+        throw std::out_of_range("Index out of range");
+    }
+    return buffer[index(i)];
+}
+
+// Reference to the first element
+template <class T, class Allocator>
+T &CircularBuffer<T, Allocator>::front() {
+    if (empty()) {
+        throw std::runtime_error("Buffer is empty");
+    }
+    return buffer[start];
+}
+
+template <class T, class Allocator>
+const T &CircularBuffer<T, Allocator>::front() const {
+    if (empty()) {
+        throw std::runtime_error("Buffer is empty");
+    }
+    return buffer[start];
+}
+
+// Reference to the last element
+template <class T, class Allocator>
+T &CircularBuffer<T, Allocator>::back() {
+    if (empty()) {
+        throw std::runtime_error("Buffer is empty");
+    }
+    return buffer[prev(finish)];
+}
+
+template <class T, class Allocator>
+const T &CircularBuffer<T, Allocator>::back() const {
+    if (empty()) {
+        throw std::runtime_error("Buffer is empty");
+    }
+    return buffer[prev(finish)];
+}
+
+// Linearizes the buffer so that the first element is at the beginning of allocated memory
+// Works in place and never allocates
+template <class T, class Allocator>
+T *CircularBuffer<T, Allocator>::linearize() {
+    if (is_linearized() || empty()) {
+        return buffer;
+    }
+
+    if (full()) {
+        // No free slots: rotate the whole array
+        if constexpr (std::is_trivially_copyable<value_type>::value) {
+            rotate_blocks(buffer, buffer + start, buffer + cap);
+        } else {
+            std::rotate(buffer, buffer + start, buffer + cap);
+        }
+    } else if (start + count <= cap) {
+        // One segment away from the beginning: slide it down
+        relocate_down(start, 0, count);
+    } else {
+        // Two segments [start, cap) and [0, finish): close the gap between them,
+        // then rotate the now contiguous [0, count) range
+        relocate_down(start, finish, cap - start);
+        if constexpr (std::is_trivially_copyable<value_type>::value) {
+            rotate_blocks(buffer, buffer + finish, buffer + count);
+        } else {
+            std::rotate(buffer, buffer + finish, buffer + count);
+        }
+    }
+    start = 0;
+    finish = count % cap;
+
+    return buffer;
+}
+
+// Checks if the buffer is linearized
+template <class T, class Allocator>
+bool CircularBuffer<T, Allocator>::is_linearized() const {
+    return start == 0 || empty();
+}
+
+// Rotates the buffer so that the element at new_begin becomes the first element
+template <class T, class Allocator>
+void CircularBuffer<T, Allocator>::rotate(int new_begin) {
+    if (new_begin < 0 || new_begin >= count) {
+        throw std::out_of_range("new_begin out of range");
+    }
+    if (full()) {
+        // Every slot holds an element, so moving the start is enough
+        start = index(new_begin);
+        finish = start;
+        return;
+    }
+    if constexpr (std::is_trivially_copyable<value_type>::value) {
+        // Block copies beat element-wise moves; the result is already linearized
+        linearize();
+        rotate_blocks(buffer, buffer + new_begin, buffer + count);
+        return;
+    }
+    // Move the shorter side around the ring through the free slots
+    if (new_begin <= count - new_begin) {
+        for (int i = 0; i < new_begin; ++i) {
+            emplace_back(std::move(buffer[start]));
+            pop_front();
+        }
+    } else {
+        for (int i = count - new_begin; i > 0; --i) {
+            emplace_front(std::move(buffer[(finish - 1 + cap) % cap]));
+            pop_back();
+        }
+    }
+}
+
+// Returns the number of elements stored in the buffer
+template <class T, class Allocator>
+int CircularBuffer<T, Allocator>::size() const {
+    return count;
+}
+
+// Checks if the buffer is empty
+template <class T, class Allocator>
+bool CircularBuffer<T, Allocator>::empty() const {
+    return count == 0;
+}
+
+// Checks if the buffer is full (size == capacity)
+template <class T, class Allocator>
+bool CircularBuffer<T, Allocator>::full() const {
+    return count == cap;
+}
+
+// Returns the number of free slots in the buffer
+template <class T, class Allocator>
+int CircularBuffer<T, Allocator>::reserve() const {
+    return cap - count;
+}
+
+// Returns the capacity of the buffer
+template <class T, class Allocator>
+int CircularBuffer<T, Allocator>::capacity() const {
+    return cap;
+}
+
+// Returns a copy of the allocator
+template <class T, class Allocator>
+Allocator CircularBuffer<T, Allocator>::get_allocator() const {
+    return alloc;
+}
+
+// Sets a new capacity for the buffer
+template <class T, class Allocator>
+void CircularBuffer<T, Allocator>::set_capacity(int new_capacity) {
+    if (new_capacity < 0) {
+        throw std::invalid_argument("new_capacity must be non-negative");
+    }
+    if (new_capacity == cap) {
+        return;
+    }
+    pointer new_buffer = allocate(new_capacity);
+    int new_count = std::min(count, new_capacity);
+    if constexpr (std::is_trivially_copyable<value_type>::value) {
+        // Relink the two segments with at most two bulk copies
+        if (new_count > 0) {
+            copy_out(start, new_buffer, new_count);
+        }
+        release();
+        buffer = new_buffer;
+        cap = new_capacity;
+        start = 0;
+        count = new_count;
+        finish = cap == 0 ? 0 : count % cap;
+        return;
+    }
+    int moved = 0;
+    try {
+        for (; moved < new_count; ++moved) {
+            alloc_traits::construct(alloc, new_buffer + moved, std::move_if_noexcept(buffer[index(moved)]));
+        }
+    } catch (...) {
+        for (int i = 0; i < moved; ++i) {
+            alloc_traits::destroy(alloc, new_buffer + i);
+        }
+        if (new_buffer) {
+            alloc_traits::deallocate(alloc, new_buffer, new_capacity);
+        }
+        throw;
+    }
+    release();
+    buffer = new_buffer;
+    cap = new_capacity;
+    start = 0;
+    count = new_count;
+    finish = cap == 0 ? 0 : count % cap;
+}
+
+// Resizes the buffer
+// If the buffer is expanded, new elements are value-initialized
+template <class T, class Allocator>
+void CircularBuffer<T, Allocator>::resize(int new_size) {
+    if (new_size < 0 || new_size > cap) {
+        throw std::invalid_argument("new_size must be between 0 and capacity");
+    }
+    // Shrinking the buffer
+    while (count > new_size) {
+        pop_back();
+    }
+    // Expanding the buffer
+    while (count < new_size) {
+        emplace_back();
+    }
+}
+
+// Resizes the buffer
+// If the buffer is expanded, new elements are filled with item
+template <class T, class Allocator>
+void CircularBuffer<T, Allocator>::resize(int new_size, const value_type &item) {
+    if (new_size < 0 || new_size > cap) {
+        throw std::invalid_argument("new_size must be between 0 and capacity");
+    }
+    // Shrinking the buffer
+    while (count > new_size) {
+        pop_back();
+    }
+    // Expanding the buffer
+    while (count < new_size) {
+        push_back(item);
+    }
+}
+
+// Assignment operator
+// Keeps the current allocator unless the allocator propagates on copy assignment
+template <class T, class Allocator>
+CircularBuffer<T, Allocator> &CircularBuffer<T, Allocator>::operator=(const CircularBuffer &cb) {
+    if (this == &cb) {
+        return *this;
+    }
+    constexpr bool propagate = alloc_traits::propagate_on_container_copy_assignment::value;
+    CircularBuffer copy(cb, propagate ? cb.alloc : alloc);
+    // The copy was allocated with the allocator we end up with, so its storage can be adopted
+    release();
+    if constexpr (propagate) {
+        alloc = copy.alloc;
+    }
+    steal(copy);
+    return *this;
+}
+
+// Move assignment operator
+// O(1) unless the allocators differ and do not propagate
+template <class T, class Allocator>
+CircularBuffer<T, Allocator> &CircularBuffer<T, Allocator>::operator=(CircularBuffer &&cb) noexcept(
+    std::allocator_traits<Allocator>::propagate_on_container_move_assignment::value ||
+    std::allocator_traits<Allocator>::is_always_equal::value) {
+    if (this == &cb) {
+        return *this;
+    }
+    release();
+    if constexpr (alloc_traits::propagate_on_container_move_assignment::value) {
+        alloc = std::move(cb.alloc);
+        steal(cb);
+    } else {
+        if (alloc == cb.alloc) {
+            steal(cb);
+            return *this;
+        }
+        // Storage from a foreign allocator cannot be adopted, move element by element
+        buffer = allocate(cb.cap);
+        cap = cb.cap;
+        for (; count < cb.count; ++count) {
+            alloc_traits::construct(alloc, buffer + count, std::move(cb[count]));
+        }
+        finish = cap == 0 ? 0 : count % cap;
+        cb.clear();
+    }
+    return *this;
+}
+
+// Swaps the contents of the buffer with another buffer
+// The allocators are swapped only if they propagate on swap, otherwise they must be equal
+template <class T, class Allocator>
+void CircularBuffer<T, Allocator>::swap(CircularBuffer &cb) {
+    if constexpr (alloc_traits::propagate_on_container_swap::value) {
+        std::swap(alloc, cb.alloc);
+    }
+    std::swap(buffer, cb.buffer);
+    std::swap(cap, cb.cap);
+    std::swap(start, cb.start);
+    std::swap(finish, cb.finish);
+    std::swap(count, cb.count);
+}
+
+// Adds an element to the end of the buffer
+// If the buffer is full, the first element is overwritten
+template <class T, class Allocator>
+void CircularBuffer<T, Allocator>::push_back(const value_type &item) {
+    store_back(item);
+}
+
+template <class T, class Allocator>
+void CircularBuffer<T, Allocator>::push_back(value_type &&item) {
+    store_back(std::move(item));
+}
+
+// Adds a new element before the first element of the buffer
+// If the buffer is full, the last element is overwritten
+template <class T, class Allocator>
+void CircularBuffer<T, Allocator>::push_front(const value_type &item) {
+    store_front(item);
+}
+
+template <class T, class Allocator>
+void CircularBuffer<T, Allocator>::push_front(value_type &&item) {
+    store_front(std::move(item));
+}
+
+// Constructs an element in place after the last element
+// If the buffer is full, the first element is overwritten by a temporary built from args
+template <class T, class Allocator>
+template <class... Args>
+T &CircularBuffer<T, Allocator>::emplace_back(Args &&...args) {
+    if (cap == 0) {
+        throw std::runtime_error("Buffer capacity is zero");
+    }
+    if (full()) {
+        store_back(value_type(std::forward<Args>(args)...));
+    } else {
+        alloc_traits::construct(alloc, buffer + finish, std::forward<Args>(args)...);
+        finish = next(finish);
+        ++count;
+    }
+    return buffer[prev(finish)];
+}
+
+// Constructs an element in place before the first element
+// If the buffer is full, the last element is overwritten by a temporary built from args
+template <class T, class Allocator>
+template <class... Args>
+T &CircularBuffer<T, Allocator>::emplace_front(Args &&...args) {
+    if (cap == 0) {
+        throw std::runtime_error("Buffer capacity is zero");
+    }
+    if (full()) {
+        store_front(value_type(std::forward<Args>(args)...));
+    } else {
+        int new_start = prev(start);
+        alloc_traits::construct(alloc, buffer + new_start, std::forward<Args>(args)...);
+        start = new_start;
+        ++count;
+    }
+    return buffer[start];
+}
+
+// Adds n elements to the end of the buffer
+// Equivalent to calling push_back for data[0], ..., data[n - 1]
+template <class T, class Allocator>
+void CircularBuffer<T, Allocator>::push_back(const value_type *data, int n) {
+    if (n < 0) {
+        throw std::invalid_argument("n must be non-negative");
+    }
+    if (n == 0) {
+        return;
+    }
+    if (cap == 0) {
+        throw std::runtime_error("Buffer capacity is zero");
+    }
+    if constexpr (!std::is_trivially_copyable<value_type>::value) {
+        // Element-wise fallback; only the last cap elements survive
+        for (int i = std::max(0, n - cap); i < n; ++i) {
+            push_back(data[i]);
+        }
+    } else {
+        if (n >= cap) {
+            // Only the last cap elements survive
+            std::memcpy(buffer, data + (n - cap), cap * sizeof(value_type));
+            start = 0;
+            finish = 0;
+            count = cap;
+            return;
+        }
+        copy_in(finish, data, n);
+        finish = (finish + n) % cap;
+        if (count + n > cap) {
+            start = finish;
+            count = cap;
+        } else {
+            count += n;
+        }
+    }
+}
+
+// Adds n elements before the first element so that data[0] becomes the first one
+// Equivalent to calling push_front for data[n - 1], ..., data[0]
+template <class T, class Allocator>
+void CircularBuffer<T, Allocator>::push_front(const value_type *data, int n) {
+    if (n < 0) {
+        throw std::invalid_argument("n must be non-negative");
+    }
+    if (n == 0) {
+        return;
+    }
+    if (cap == 0) {
+        throw std::runtime_error("Buffer capacity is zero");
+    }
+    if constexpr (!std::is_trivially_copyable<value_type>::value) {
+        // Element-wise fallback; only the first cap elements survive
+        for (int i = std::min(n, cap) - 1; i >= 0; --i) {
+            push_front(data[i]);
+        }
+    } else {
+        if (n >= cap) {
+            // Only the first cap elements survive
+            std::memcpy(buffer, data, cap * sizeof(value_type));
+            start = 0;
+            finish = 0;
+            count = cap;
+            return;
+        }
+        start = (start - n + cap) % cap;
+        copy_in(start, data, n);
+        if (count + n > cap) {
+            finish = start;
+            count = cap;
+        } else {
+            count += n;
+        }
+    }
+}
+
+// Removes the last element of the buffer
+template <class T, class Allocator>
+void CircularBuffer<T, Allocator>::pop_back() {
+    if (empty()) {
+        throw std::runtime_error("Buffer is empty");
+    }
+    finish = prev(finish);
+    alloc_traits::destroy(alloc, buffer + finish);
+    --count;
+}
+
+// Removes the first element of the buffer
+template <class T, class Allocator>
+void CircularBuffer<T, Allocator>::pop_front() {
+    if (empty()) {
+        throw std::runtime_error("Buffer is empty");
+    }
+    alloc_traits::destroy(alloc, buffer + start);
+    start = next(start);
+    --count;
+}
+
+// Removes the last n elements of the buffer and copies them in order into out
+template <class T, class Allocator>
+void CircularBuffer<T, Allocator>::pop_back(value_type *out, int n) {
+    if (n < 0) {
+        throw std::invalid_argument("n must be non-negative");
+    }
+    if (n > count) {
+        throw std::runtime_error("Not enough elements in the buffer");
+    }
+    if (n == 0) {
+        return;
+    }
+    if constexpr (std::is_trivially_copyable<value_type>::value) {
+        copy_out((finish - n + cap) % cap, out, n);
+    } else {
+        for (int i = 0; i < n; ++i) {
+            out[i] = buffer[index(count - n + i)];
+        }
+    }
+    if constexpr (std::is_trivially_destructible<value_type>::value) {
+        finish = (finish - n + cap) % cap;
+        count -= n;
+    } else {
+        for (int i = 0; i < n; ++i) {
+            pop_back();
+        }
+    }
+}
+
+// Removes the first n elements of the buffer and copies them into out
+template <class T, class Allocator>
+void CircularBuffer<T, Allocator>::pop_front(value_type *out, int n) {
+    if (n < 0) {
+        throw std::invalid_argument("n must be non-negative");
+    }
+    if (n > count) {
+        throw std::runtime_error("Not enough elements in the buffer");
+    }
+    if (n == 0) {
+        return;
+    }
+    if constexpr (std::is_trivially_copyable<value_type>::value) {
+        copy_out(start, out, n);
+    } else {
+        for (int i = 0; i < n; ++i) {
+            out[i] = buffer[index(i)];
+        }
+    }
+    if constexpr (std::is_trivially_destructible<value_type>::value) {
+        start = (start + n) % cap;
+        count -= n;
+    } else {
+        for (int i = 0; i < n; ++i) {
+            pop_front();
+        }
+    }
+}
+
+// Inserts an element at the specified position
+// The capacity of the buffer remains unchanged
+template <class T, class Allocator>
+void CircularBuffer<T, Allocator>::insert(int pos, const value_type &item) {
+    emplace(pos, item);
+}
+
+template <class T, class Allocator>
+void CircularBuffer<T, Allocator>::insert(int pos, value_type &&item) {
+    emplace(pos, std::move(item));
+}
+
+// Inserts the elements of [first, last) at the specified position with a single shift
+// The capacity of the buffer remains unchanged
+template <class T, class Allocator>
+template <class ForwardIt, class>
+void CircularBuffer<T, Allocator>::insert(int pos, ForwardIt first, ForwardIt last) {
+    if (pos < 0 || pos > count) {
+        throw std::out_of_range("Position out of range");
+    }
+    auto k = std::distance(first, last);
+    if (k == 0) {
+        return;
+    }
+    if (k > reserve()) {
+        throw std::runtime_error("Not enough free space in the buffer");
+    }
+    std::pair<int, int> raw = open_gap(pos, static_cast<int>(k));
+    for (int i = 0; first != last; ++first, ++i) {
+        pointer slot = buffer + index(pos + i);
+        if (i >= raw.first && i < raw.second) {
+            alloc_traits::construct(alloc, slot, *first);
+        } else {
+            *slot = *first;
+        }
+    }
+}
+
+// Constructs an element at the specified position
+// Only an element appended at either end is built directly in its slot;
+// otherwise a temporary is moved in after the shift
+template <class T, class Allocator>
+template <class... Args>
+T &CircularBuffer<T, Allocator>::emplace(int pos, Args &&...args) {
+    if (pos < 0 || pos > count) {
+        throw std::out_of_range("Position out of range");
+    }
+    if (cap == 0) {
+        throw std::runtime_error("Buffer capacity is zero");
+    }
+    if (full()) {
+        throw std::runtime_error("Buffer is full");
+    }
+    if (pos == count) {
+        return emplace_back(std::forward<Args>(args)...);
+    }
+    if (pos == 0) {
+        return emplace_front(std::forward<Args>(args)...);
+    }
+    value_type copy(std::forward<Args>(args)...);
+    std::pair<int, int> raw = open_gap(pos, 1);
+    pointer slot = buffer + index(pos);
+    if (raw.first < raw.second) {
+        alloc_traits::construct(alloc, slot, std::move(copy));
+    } else {
+        *slot = std::move(copy);
+    }
+    return *slot;
+}
+
+// Erases elements in the range [first, last)
+// Shifts whichever side of the range is shorter
+template <class T, class Allocator>
+void CircularBuffer<T, Allocator>::erase(int first, int last) {
+    if (first < 0 || last > count || first >= last) {
+        throw std::out_of_range("Invalid range");
+    }
+    int num_erased = last - first;
+    bool from_front = first < count - last;
+    if (from_front) {
+        // Close the gap from the front; the first num_erased slots are vacated
+        shift(0, num_erased, first);
+    } else {
+        shift(last, first, count - last);
+    }
+    if constexpr (std::is_trivially_destructible<value_type>::value) {
+        if (from_front) {
+            start = (start + num_erased) % cap;
+        }
+        count -= num_erased;
+        finish = (start + count) % cap;
+    } else {
+        for (int i = 0; i < num_erased; ++i) {
+            if (from_front) {
+                pop_front();
+            } else {
+                pop_back();
+            }
+        }
+    }
+}
+
+// Clears the buffer
+template <class T, class Allocator>
+void CircularBuffer<T, Allocator>::clear() {
+    if constexpr (!std::is_trivially_destructible<value_type>::value) {
+        for (int i = 0; i < count; ++i) {
+            alloc_traits::destroy(alloc, buffer + index(i));
+        }
+    }
+    start = 0;
+    finish = 0;
+    count = 0;
+}
+
+// Returns up to two spans of free storage following the last element, in order
+// Only for trivially copyable types; the spans stay valid until the next modification
+template <class T, class Allocator>
+std::array<typename CircularBuffer<T, Allocator>::region, 2> CircularBuffer<T, Allocator>::write_regions() {
+    static_assert(std::is_trivially_copyable<value_type>::value,
+                  "write_regions requires a trivially copyable value_type");
+    if (empty()) {
+        // Restart at the beginning so the free space is a single span
+        start = 0;
+        finish = 0;
+    }
+    int free_slots = cap - count;
+    int first = std::min(free_slots, cap - finish);
+    return {{{buffer + finish, first}, {buffer, free_slots - first}}};
+}
+
+// Publishes the first n elements written into the spans from write_regions()
+template <class T, class Allocator>
+void CircularBuffer<T, Allocator>::commit_write(int n) {
+    static_assert(std::is_trivially_copyable<value_type>::value,
+                  "commit_write requires a trivially copyable value_type");
+    if (n < 0 || n > reserve()) {
+        throw std::out_of_range("n exceeds the free space");
+    }
+    if (n == 0) {
+        return;
+    }
+    finish = (finish + n) % cap;
+    count += n;
+}
+
+// Returns up to two spans holding the elements, in order
+template <class T, class Allocator>
+std::array<typename CircularBuffer<T, Allocator>::region, 2> CircularBuffer<T, Allocator>::read_regions() {
+    int first = std::min(count, cap - start);
+    return {{{buffer + start, first}, {buffer, count - first}}};
+}
+
+template <class T, class Allocator>
+std::array<typename CircularBuffer<T, Allocator>::const_region, 2>
+CircularBuffer<T, Allocator>::read_regions() const {
+    int first = std::min(count, cap - start);
+    return {{{buffer + start, first}, {buffer, count - first}}};
+}
+
+// Returns up to two spans holding the elements from position pos on, in order
+template <class T, class Allocator>
+std::array<typename CircularBuffer<T, Allocator>::const_region, 2>
+CircularBuffer<T, Allocator>::regions_from(int pos) const {
+    int j = index(pos);
+    int n = count - pos;
+    int first = std::min(n, cap - j);
+    return {{{buffer + j, first}, {buffer, n - first}}};
+}
+
+// Returns the index of the first element equal to value at or after pos, -1 if there is none
+// Byte elements are scanned with SIMD kernels, one call per contiguous span
+template <class T, class Allocator>
+int CircularBuffer<T, Allocator>::find(const value_type &value, int pos) const {
+    if (pos < 0 || pos > count) {
+        throw std::out_of_range("Position out of range");
+    }
+    int offset = pos;
+    for (const const_region &r : regions_from(pos)) {
+        const_pointer last = r.data + r.size;
+        const_pointer hit;
+        if constexpr (byte_elements) {
+            hit = reinterpret_cast<const_pointer>(scan_find(reinterpret_cast<const char *>(r.data),
+                                                            reinterpret_cast<const char *>(last),
+                                                            static_cast<char>(value)));
+        } else {
+            hit = std::find(r.data, last, value);
+        }
+        if (hit != last) {
+            return offset + static_cast<int>(hit - r.data);
+        }
+        offset += r.size;
+    }
+    return -1;
+}
+
+// Returns the index of the first occurrence of seq[0, n) starting at or after pos, -1 if there is none
+// Occurrences may wrap around the end of the storage
+template <class T, class Allocator>
+int CircularBuffer<T, Allocator>::find(const value_type *seq, int n, int pos) const {
+    if (pos < 0 || pos > count) {
+        throw std::out_of_range("Position out of range");
+    }
+    if (n < 0) {
+        throw std::invalid_argument("n must be non-negative");
+    }
+    if (n == 0) {
+        return pos;
+    }
+    if (n > count - pos) {
+        return -1;
+    }
+    auto search = [seq, n](const_pointer first, const_pointer last) {
+        if constexpr (byte_elements) {
+            return reinterpret_cast<const_pointer>(scan_search(reinterpret_cast<const char *>(first),
+                                                               reinterpret_cast<const char *>(last),
+                                                               reinterpret_cast<const char *>(seq),
+                                                               static_cast<std::size_t>(n)));
+        } else {
+            return std::search(first, last, seq, seq + n);
+        }
+    };
+    std::array<const_region, 2> r = regions_from(pos);
+    const_pointer hit = search(r[0].data, r[0].data + r[0].size);
+    if (hit != r[0].data + r[0].size) {
+        return pos + static_cast<int>(hit - r[0].data);
+    }
+    if (r[1].size == 0) {
+        return -1;
+    }
+    // Occurrences that start in the first span and end in the second one
+    for (int s = std::max(0, r[0].size - n + 1); s < r[0].size; ++s) {
+        int head = r[0].size - s;
+        if (n - head <= r[1].size && std::equal(r[0].data + s, r[0].data + r[0].size, seq) &&
+            std::equal(r[1].data, r[1].data + (n - head), seq + head)) {
+            return pos + s;
+        }
+    }
+    hit = search(r[1].data, r[1].data + r[1].size);
+    if (hit != r[1].data + r[1].size) {
+        return pos + r[0].size + static_cast<int>(hit - r[1].data);
+    }
+    return -1;
+}
+
+// Removes the first n elements of the buffer
+template <class T, class Allocator>
+void CircularBuffer<T, Allocator>::consume(int n) {
+    if (n < 0 || n > count) {
+        throw std::out_of_range("n exceeds the number of elements");
+    }
+    if (n == 0) {
+        return;
+    }
+    if constexpr (std::is_trivially_destructible<value_type>::value) {
+        start = (start + n) % cap;
+        count -= n;
+    } else {
+        for (int i = 0; i < n; ++i) {
+            pop_front();
+        }
+    }
+}
+
+// Iterators over the elements in logical order
+template <class T, class Allocator>
+typename CircularBuffer<T, Allocator>::iterator CircularBuffer<T, Allocator>::begin() {
+    return iterator(buffer, cap, start, 0);
+}
+
+template <class T, class Allocator>
+typename CircularBuffer<T, Allocator>::iterator CircularBuffer<T, Allocator>::end() {
+    return iterator(buffer, cap, start, count);
+}
+
+template <class T, class Allocator>
+typename CircularBuffer<T, Allocator>::const_iterator CircularBuffer<T, Allocator>::begin() const {
+    return const_iterator(buffer, cap, start, 0);
+}
+
+template <class T, class Allocator>
+typename CircularBuffer<T, Allocator>::const_iterator CircularBuffer<T, Allocator>::end() const {
+    return const_iterator(buffer, cap, start, count);
+}
+
+template <class T, class Allocator>
+typename CircularBuffer<T, Allocator>::const_iterator CircularBuffer<T, Allocator>::cbegin() const {
+    return begin();
+}
+
+template <class T, class Allocator>
+typename CircularBuffer<T, Allocator>::const_iterator CircularBuffer<T, Allocator>::cend() const {
+    return end();
+}
+
+template <class T, class Allocator>
+typename CircularBuffer<T, Allocator>::reverse_iterator CircularBuffer<T, Allocator>::rbegin() {
+    return reverse_iterator(end());
+}
+
+template <class T, class Allocator>
+typename CircularBuffer<T, Allocator>::reverse_iterator CircularBuffer<T, Allocator>::rend() {
+    return reverse_iterator(begin());
+}
+
+template <class T, class Allocator>
+typename CircularBuffer<T, Allocator>::const_reverse_iterator CircularBuffer<T, Allocator>::rbegin() const {
+    return const_reverse_iterator(end());
+}
+
+template <class T, class Allocator>
+typename CircularBuffer<T, Allocator>::const_reverse_iterator CircularBuffer<T, Allocator>::rend() const {
+    return const_reverse_iterator(begin());
+}
+
+template <class T, class Allocator>
+typename CircularBuffer<T, Allocator>::const_reverse_iterator CircularBuffer<T, Allocator>::crbegin() const {
+    return rbegin();
+}
+
+template <class T, class Allocator>
+typename CircularBuffer<T, Allocator>::const_reverse_iterator CircularBuffer<T, Allocator>::crend() const {
+    return rend();
+}
+
+// Calls f(first, last) with raw pointer ranges for each of the (at most two)
+// contiguous runs of elements, in order
+template <class T, class Allocator>
+template <class F>
+void CircularBuffer<T, Allocator>::for_each_segment(F f) {
+    for (const region &r : read_regions()) {
+        if (r.size > 0) {
+            f(r.data, r.data + r.size);
+        }
+    }
+}
+
+template <class T, class Allocator>
+template <class F>
+void CircularBuffer<T, Allocator>::for_each_segment(F f) const {
+    for (const const_region &r : read_regions()) {
+        if (r.size > 0) {
+            f(r.data, r.data + r.size);
+        }
+    }
+}
+
+// Calls f on the first min(n, size()) elements, then removes them with a single update of the head
+// f takes either a contiguous run (pointer first, pointer last) or one element by reference;
+// if f throws, no element is removed
+// Returns the number of elements removed
+template <class T, class Allocator>
+template <class F>
+int CircularBuffer<T, Allocator>::consume_up_to(int n, F f) {
+    if (n < 0) {
+        throw std::invalid_argument("n must be non-negative");
+    }
+    int k = std::min(n, count);
+    int first = std::min(k, cap - start);
+    detail::consume_run(buffer + start, static_cast<std::size_t>(first), f);
+    detail::consume_run(buffer, static_cast<std::size_t>(k - first), f);
+    consume(k);
+    return k;
+}
+
+// Calls f on every element, then removes them all; see consume_up_to
+template <class T, class Allocator>
+template <class F>
+int CircularBuffer<T, Allocator>::consume_all(F f) {
+    return consume_up_to(count, std::move(f));
+}
+
+// Copies the elements in order to out
+template <class T, class Allocator, class OutputIt>
+OutputIt segmented_copy(const CircularBuffer<T, Allocator> &cb, OutputIt out) {
+    cb.for_each_segment([&out](const T *first, const T *last) {
+        out = std::copy(first, last, out);
+    });
+    return out;
+}
+
+// Assigns value to every element
+template <class T, class Allocator>
+void segmented_fill(CircularBuffer<T, Allocator> &cb, const T &value) {
+    cb.for_each_segment([&value](T *first, T *last) {
+        std::fill(first, last, value);
+    });
+}
+
+// Returns an iterator to the first element equal to value, or end()
+template <class T, class Allocator>
+typename CircularBuffer<T, Allocator>::const_iterator
+segmented_find(const CircularBuffer<T, Allocator> &cb, const T &value) {
+    int i = cb.find(value);
+    return cb.begin() + (i < 0 ? cb.size() : i);
+}
+
+// Returns the number of elements equal to value
+template <class T, class Allocator>
+int segmented_count(const CircularBuffer<T, Allocator> &cb, const T &value) {
+    std::size_t n = 0;
+    cb.for_each_segment([&](const T *first, const T *last) {
+        if constexpr (std::is_integral<T>::value && sizeof(T) == 1) {
+            n += scan_count(reinterpret_cast<const char *>(first), reinterpret_cast<const char *>(last),
+                            static_cast<char>(value));
+        } else {
+            n += static_cast<std::size_t>(std::count(first, last, value));
+        }
+    });
+    return static_cast<int>(n);
+}
+
 // Equality operators
-bool operator==(const CircularBuffer& a, const CircularBuffer& b);
-bool operator!=(const CircularBuffer& a, const CircularBuffer& b);
+// Compare the contiguous spans of both buffers pairwise, with memcmp for
+// integral and enum types, whose bytes alone decide equality
+template <class T, class Allocator>
+bool operator==(const CircularBuffer<T, Allocator> &a, const CircularBuffer<T, Allocator> &b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    auto ra = a.read_regions();
+    auto rb = b.read_regions();
+    // The two splits cut the elements into at most three pieces
+    int ia = 0, ib = 0, oa = 0, ob = 0;
+    for (int left = a.size(); left > 0;) {
+        if (oa == ra[ia].size) {
+            ++ia;
+            oa = 0;
+            continue;
+        }
+        if (ob == rb[ib].size) {
+            ++ib;
+            ob = 0;
+            continue;
+        }
+        int n = std::min(ra[ia].size - oa, rb[ib].size - ob);
+        const T *pa = ra[ia].data + oa;
+        const T *pb = rb[ib].data + ob;
+        if constexpr (std::is_integral<T>::value || std::is_enum<T>::value) {
+            if (std::memcmp(pa, pb, n * sizeof(T)) != 0) {
+                return false;
+            }
+        } else if (!std::equal(pa, pa + n, pb)) {
+            return false;
+        }
+        oa += n;
+        ob += n;
+        left -= n;
+    }
+    return true;
+}
 
+template <class T, class Allocator>
+bool operator!=(const CircularBuffer<T, Allocator> &a, const CircularBuffer<T, Allocator> &b) {
+    return !(a == b);
+}
@@ -0,0 +1,391 @@
+#pragma once
+
+#include <climits>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+#include "circular-buffer.h"
+
+// Circular buffer that never drops data: a push or insert into a full
+// buffer first grows the capacity by growth_factor, so a sequence of pushes
+// costs amortized O(1). Optionally, when the occupancy falls below
+// shrink_threshold after a removal, the capacity shrinks to
+// size() * growth_factor, but never below the initial capacity.
+// Each resize relinks the two wrapped segments with at most two bulk copies
+// for trivially copyable types.
+template <class T = char, class Allocator = std::allocator<T>>
+class GrowableCircularBuffer {
+public:
+    typedef T value_type;
+    typedef Allocator allocator_type;
+    typedef typename CircularBuffer<T, Allocator>::iterator iterator;
+    typedef typename CircularBuffer<T, Allocator>::const_iterator const_iterator;
+
+private:
+    CircularBuffer<T, Allocator> ring;   // Storage, resized on demand
+    double growth;                       // Factor by which a full buffer grows
+    double shrink_below;                 // Occupancy that triggers shrinking, 0 to never shrink
+    int min_capacity;                    // Capacity given at construction
+
+    // Grows the capacity to make room for at least n more elements
+    void grow(int n);
+
+    // Shrinks the capacity if the occupancy fell below the threshold
+    void maybe_shrink();
+
+public:
+    // Constructs a buffer with a given initial capacity and resizing policy
+    // growth_factor must be above 1; shrink_threshold must be 0 or below 1 / growth_factor
+    explicit GrowableCircularBuffer(int capacity = 0, double growth_factor = 2.0, double shrink_threshold = 0.0,
+                                    const allocator_type& allocator = allocator_type());
+
+    // Access by index without bounds checking
+    value_type& operator[](int i);
+    const value_type& operator[](int i) const;
+
+    // Access by index with bounds checking
+    value_type& at(int i);
+    const value_type& at(int i) const;
+
+    // Reference to the first element
+    value_type& front();
+    const value_type& front() const;
+
+    // Reference to the last element
+    value_type& back();
+    const value_type& back() const;
+
+    // Linearizes the buffer so that the first element is at the beginning of allocated memory
+    value_type* linearize();
+
+    // Returns the number of elements stored in the buffer
+    int size() const;
+
+    // Checks if the buffer is empty
+    bool empty() const;
+
+    // Returns the current capacity of the buffer
+    int capacity() const;
+
+    // Returns the factor by which a full buffer grows
+    double growth_factor() const;
+
+    // Returns the occupancy below which the buffer shrinks, 0 if it never shrinks
+    double shrink_threshold() const;
+
+    // Adds an element to the end of the buffer, growing it if full
+    void push_back(const value_type& item);
+    void push_back(value_type&& item);
+
+    // Adds a new element before the first element of the buffer, growing it if full
+    void push_front(const value_type& item);
+    void push_front(value_type&& item);
+
+    // Constructs an element in place after the last element, growing the buffer if full
+    template <class... Args>
+    value_type& emplace_back(Args&&... args);
+
+    // Constructs an element in place before the first element, growing the buffer if full
+    template <class... Args>
+    value_type& emplace_front(Args&&... args);
+
+    // Adds n elements to the end of the buffer, growing it as needed
+    void push_back(const value_type* data, int n);
+
+    // Removes the last element of the buffer
+    void pop_back();
+
+    // Removes the first element of the buffer
+    void pop_front();
+
+    // Inserts an element at the specified position, growing the buffer if full
+    void insert(int pos, const value_type& item);
+
+    // Inserts the elements of [first, last) at the specified position, growing the buffer as needed
+    template <class ForwardIt, class = typename std::enable_if<std::is_base_of<
+        std::forward_iterator_tag, typename std::iterator_traits<ForwardIt>::iterator_category>::value>::type>
+    void insert(int pos, ForwardIt first, ForwardIt last);
+
+    // Erases elements in the range [first, last)
+    void erase(int first, int last);
+
+    // Clears the buffer, keeping the capacity
+    void clear();
+
+    // Shrinks the capacity to max(size(), initial capacity)
+    void shrink_to_fit();
+
+    // Iterators over the elements in logical order
+    iterator begin();
+    iterator end();
+    const_iterator begin() const;
+    const_iterator end() const;
+
+    // Returns the underlying fixed-capacity buffer
+    const CircularBuffer<T, Allocator>& buffer() const;
+};
+
+// Constructs a buffer with a given initial capacity and resizing policy
+// growth_factor must be above 1; shrink_threshold must be 0 or below 1 / growth_factor
+template <class T, class Allocator>
+GrowableCircularBuffer<T, Allocator>::GrowableCircularBuffer(int capacity, double growth_factor,
+                                                             double shrink_threshold,
+                                                             const allocator_type &allocator)
+    : ring(capacity, allocator), growth(growth_factor), shrink_below(shrink_threshold), min_capacity(capacity) {
+    if (!(growth_factor > 1.0)) {
+        throw std::invalid_argument("growth_factor must be above 1");
+    }
+    // Shrinking to size() * growth must not leave the buffer below the threshold again
+    if (shrink_threshold < 0.0 || shrink_threshold * growth_factor >= 1.0) {
+        throw std::invalid_argument("shrink_threshold must be between 0 and 1 / growth_factor");
+    }
+}
+
+// Grows the capacity to make room for at least n more elements
+template <class T, class Allocator>
+void GrowableCircularBuffer<T, Allocator>::grow(int n) {
+    long long needed = static_cast<long long>(ring.size()) + n;
+    if (needed <= ring.capacity()) {
+        return;
+    }
+    if (needed > INT_MAX) {
+        throw std::runtime_error("Buffer capacity limit reached");
+    }
+    double grown = std::ceil(ring.capacity() * growth);
+    long long new_capacity = std::max<long long>(needed, grown > INT_MAX ? INT_MAX : static_cast<long long>(grown));
+    ring.set_capacity(static_cast<int>(std::max<long long>(new_capacity, 1)));
+}
+
+// Shrinks the capacity if the occupancy fell below the threshold
+template <class T, class Allocator>
+void GrowableCircularBuffer<T, Allocator>::maybe_shrink() {
+    if (shrink_below > 0.0 && ring.capacity() > min_capacity && ring.size() < shrink_below * ring.capacity()) {
+        double target = std::ceil(ring.size() * growth);
+        ring.set_capacity(std::max(min_capacity, static_cast<int>(target)));
+    }
+}
+
+// Access by index without bounds checking
+template <class T, class Allocator>
+T &GrowableCircularBuffer<T, Allocator>::operator[](int i) {
+    return ring[i];
+}
+
+template <class T, class Allocator>
+const T &GrowableCircularBuffer<T, Allocator>::operator[](int i) const {
+    return ring[i];
+}
+
+// Access by index with bounds checking
+template <class T, class Allocator>
+T &GrowableCircularBuffer<T, Allocator>::at(int i) {
+    return ring.at(i);
+}
+
+template <class T, class Allocator>
+const T &GrowableCircularBuffer<T, Allocator>::at(int i) const {
+    return ring.at(i);
+}
+
+// Reference to the first element
+template <class T, class Allocator>
+T &GrowableCircularBuffer<T, Allocator>::front() {
+    return ring.front();
+}
+
+template <class T, class Allocator>
+const T &GrowableCircularBuffer<T, Allocator>::front() const {
+    return ring.front();
+}
+
+// Reference to the last element
+template <class T, class Allocator>
+T &GrowableCircularBuffer<T, Allocator>::back() {
+    return ring.back();
+}
+
+template <class T, class Allocator>
+const T &GrowableCircularBuffer<T, Allocator>::back() const {
+    return ring.back();
+}
+
+// Linearizes the buffer so that the first element is at the beginning of allocated memory
+template <class T, class Allocator>
+T *GrowableCircularBuffer<T, Allocator>::linearize() {
+    return ring.linearize();
+}
+
+// Returns the number of elements stored in the buffer
+template <class T, class Allocator>
+int GrowableCircularBuffer<T, Allocator>::size() const {
+    return ring.size();
+}
+
+// Checks if the buffer is empty
+template <class T, class Allocator>
+bool GrowableCircularBuffer<T, Allocator>::empty() const {
+    return ring.empty();
+}
+
+// Returns the current capacity of the buffer
+template <class T, class Allocator>
+int GrowableCircularBuffer<T, Allocator>::capacity() const {
+    return ring.capacity();
+}
+
+// Returns the factor by which a full buffer grows
+template <class T, class Allocator>
+double GrowableCircularBuffer<T, Allocator>::growth_factor() const {
+    return growth;
+}
+
+// Returns the occupancy below which the buffer shrinks, 0 if it never shrinks
+template <class T, class Allocator>
+double GrowableCircularBuffer<T, Allocator>::shrink_threshold() const {
+    return shrink_below;
+}
+
+// Adds an element to the end of the buffer, growing it if full
+template <class T, class Allocator>
+void GrowableCircularBuffer<T, Allocator>::push_back(const value_type &item) {
+    emplace_back(item);
+}
+
+template <class T, class Allocator>
+void GrowableCircularBuffer<T, Allocator>::push_back(value_type &&item) {
+    emplace_back(std::move(item));
+}
+
+// Adds a new element before the first element of the buffer, growing it if full
+template <class T, class Allocator>
+void GrowableCircularBuffer<T, Allocator>::push_front(const value_type &item) {
+    emplace_front(item);
+}
+
+template <class T, class Allocator>
+void GrowableCircularBuffer<T, Allocator>::push_front(value_type &&item) {
+    emplace_front(std::move(item));
+}
+
+// Constructs an element in place after the last element, growing the buffer if full
+template <class T, class Allocator>
+template <class... Args>
+T &GrowableCircularBuffer<T, Allocator>::emplace_back(Args &&...args) {
+    if (ring.full()) {
+        // The arguments may refer to an element, build the value before moving the storage
+        value_type item(std::forward<Args>(args)...);
+        grow(1);
+        return ring.emplace_back(std::move(item));
+    }
+    return ring.emplace_back(std::forward<Args>(args)...);
+}
+
+// Constructs an element in place before the first element, growing the buffer if full
+template <class T, class Allocator>
+template <class... Args>
+T &GrowableCircularBuffer<T, Allocator>::emplace_front(Args &&...args) {
+    if (ring.full()) {
+        value_type item(std::forward<Args>(args)...);
+        grow(1);
+        return ring.emplace_front(std::move(item));
+    }
+    return ring.emplace_front(std::forward<Args>(args)...);
+}
+
+// Adds n elements to the end of the buffer, growing it as needed
+template <class T, class Allocator>
+void GrowableCircularBuffer<T, Allocator>::push_back(const value_type *data, int n) {
+    if (n < 0) {
+        throw std::invalid_argument("n must be non-negative");
+    }
+    grow(n);
+    ring.push_back(data, n);
+}
+
+// Removes the last element of the buffer
+template <class T, class Allocator>
+void GrowableCircularBuffer<T, Allocator>::pop_back() {
+    ring.pop_back();
+    maybe_shrink();
+}
+
+// Removes the first element of the buffer
+template <class T, class Allocator>
+void GrowableCircularBuffer<T, Allocator>::pop_front() {
+    ring.pop_front();
+    maybe_shrink();
+}
+
+// Inserts an element at the specified position, growing the buffer if full
+template <class T, class Allocator>
+void GrowableCircularBuffer<T, Allocator>::insert(int pos, const value_type &item) {
+    if (pos < 0 || pos > ring.size()) {
+        throw std::out_of_range("Position out of range");
+    }
+    value_type copy(item);
+    grow(1);
+    ring.insert(pos, std::move(copy));
+}
+
+// Inserts the elements of [first, last) at the specified position, growing the buffer as needed
+template <class T, class Allocator>
+template <class ForwardIt, class>
+void GrowableCircularBuffer<T, Allocator>::insert(int pos, ForwardIt first, ForwardIt last) {
+    if (pos < 0 || pos > ring.size()) {
+        throw std::out_of_range("Position out of range");
+    }
+    auto n = std::distance(first, last);
+    if (n > INT_MAX) {
+        throw std::runtime_error("Buffer capacity limit reached");
+    }
+    grow(static_cast<int>(n));
+    ring.insert(pos, first, last);
+}
+
+// Erases elements in the range [first, last)
+template <class T, class Allocator>
+void GrowableCircularBuffer<T, Allocator>::erase(int first, int last) {
+    ring.erase(first, last);
+    maybe_shrink();
+}
+
+// Clears the buffer, keeping the capacity
+template <class T, class Allocator>
+void GrowableCircularBuffer<T, Allocator>::clear() {
+    ring.clear();
+}
+
+// Shrinks the capacity to max(size(), initial capacity)
+template <class T, class Allocator>
+void GrowableCircularBuffer<T, Allocator>::shrink_to_fit() {
+    ring.set_capacity(std::max(ring.size(), min_capacity));
+}
+
+// Iterators over the elements in logical order
+template <class T, class Allocator>
+typename GrowableCircularBuffer<T, Allocator>::iterator GrowableCircularBuffer<T, Allocator>::begin() {
+    return ring.begin();
+}
+
+template <class T, class Allocator>
+typename GrowableCircularBuffer<T, Allocator>::iterator GrowableCircularBuffer<T, Allocator>::end() {
+    return ring.end();
+}
+
+template <class T, class Allocator>
+typename GrowableCircularBuffer<T, Allocator>::const_iterator GrowableCircularBuffer<T, Allocator>::begin() const {
+    return ring.begin();
+}
+
+template <class T, class Allocator>
+typename GrowableCircularBuffer<T, Allocator>::const_iterator GrowableCircularBuffer<T, Allocator>::end() const {
+    return ring.end();
+}
+
+// Returns the underlying fixed-capacity buffer
+template <class T, class Allocator>
+const CircularBuffer<T, Allocator> &GrowableCircularBuffer<T, Allocator>::buffer() const {
+    return ring;
+}
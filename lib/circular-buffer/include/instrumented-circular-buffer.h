@@ -0,0 +1,327 @@
+#pragma once
+
+#include <memory>
+#include <utility>
+
+#include "buffer-stats.h"
+#include "circular-buffer.h"
+
+// Circular buffer that reports how it is used: pushes, pops, overwritten
+// elements, high-water mark, occupancy histogram and time spent full.
+// Stats is BufferStats or NullBufferStats; with the latter every call
+// compiles down to the plain CircularBuffer one. stats() may be read from
+// another thread while the owning thread keeps using the buffer.
+template <class T = char, class Stats = DefaultBufferStats, class Allocator = std::allocator<T>>
+class InstrumentedCircularBuffer {
+public:
+    typedef T value_type;
+    typedef Stats stats_type;
+    typedef Allocator allocator_type;
+    typedef typename CircularBuffer<T, Allocator>::iterator iterator;
+    typedef typename CircularBuffer<T, Allocator>::const_iterator const_iterator;
+
+private:
+    CircularBuffer<T, Allocator> ring;   // Storage
+    Stats counters;                      // Usage statistics of ring
+
+public:
+    // Constructs a buffer with a given capacity
+    explicit InstrumentedCircularBuffer(int capacity = 0, const allocator_type& allocator = allocator_type());
+
+    // Access by index without bounds checking
+    value_type& operator[](int i);
+    const value_type& operator[](int i) const;
+
+    // Access by index with bounds checking
+    value_type& at(int i);
+    const value_type& at(int i) const;
+
+    // Reference to the first element
+    value_type& front();
+    const value_type& front() const;
+
+    // Reference to the last element
+    value_type& back();
+    const value_type& back() const;
+
+    // Returns the number of elements stored in the buffer
+    int size() const;
+
+    // Checks if the buffer is empty
+    bool empty() const;
+
+    // Checks if the buffer is full (size == capacity)
+    bool full() const;
+
+    // Returns the number of free slots in the buffer
+    int reserve() const;
+
+    // Returns the capacity of the buffer
+    int capacity() const;
+
+    // Adds an element to the end of the buffer
+    // If the buffer is full, the first element is overwritten
+    void push_back(const value_type& item);
+    void push_back(value_type&& item);
+
+    // Adds a new element before the first element of the buffer
+    // If the buffer is full, the last element is overwritten
+    void push_front(const value_type& item);
+    void push_front(value_type&& item);
+
+    // Constructs an element in place after the last element
+    template <class... Args>
+    value_type& emplace_back(Args&&... args);
+
+    // Constructs an element in place before the first element
+    template <class... Args>
+    value_type& emplace_front(Args&&... args);
+
+    // Adds n elements to the end of the buffer
+    // Equivalent to calling push_back for data[0], ..., data[n - 1]
+    void push_back(const value_type* data, int n);
+
+    // Removes the last element of the buffer
+    void pop_back();
+
+    // Removes the first element of the buffer
+    void pop_front();
+
+    // Removes the first n elements of the buffer and copies them into out
+    void pop_front(value_type* out, int n);
+
+    // Clears the buffer; counted as popping every element
+    void clear();
+
+    // Iterators over the elements in logical order
+    iterator begin();
+    iterator end();
+    const_iterator begin() const;
+    const_iterator end() const;
+
+    // Returns the usage statistics
+    const Stats& stats() const;
+
+    // Zeroes the usage statistics; only from the thread that uses the buffer
+    void reset_stats();
+
+    // Returns the underlying buffer
+    const CircularBuffer<T, Allocator>& buffer() const;
+};
+
+// Constructs a buffer with a given capacity
+template <class T, class Stats, class Allocator>
+InstrumentedCircularBuffer<T, Stats, Allocator>::InstrumentedCircularBuffer(int capacity,
+                                                                           const allocator_type &allocator)
+    : ring(capacity, allocator), counters(capacity) {}
+
+// Access by index without bounds checking
+template <class T, class Stats, class Allocator>
+T &InstrumentedCircularBuffer<T, Stats, Allocator>::operator[](int i) {
+    return ring[i];
+}
+
+template <class T, class Stats, class Allocator>
+const T &InstrumentedCircularBuffer<T, Stats, Allocator>::operator[](int i) const {
+    return ring[i];
+}
+
+// Access by index with bounds checking
+template <class T, class Stats, class Allocator>
+T &InstrumentedCircularBuffer<T, Stats, Allocator>::at(int i) {
+    return ring.at(i);
+}
+
+template <class T, class Stats, class Allocator>
+const T &InstrumentedCircularBuffer<T, Stats, Allocator>::at(int i) const {
+    return ring.at(i);
+}
+
+// Reference to the first element
+template <class T, class Stats, class Allocator>
+T &InstrumentedCircularBuffer<T, Stats, Allocator>::front() {
+    return ring.front();
+}
+
+template <class T, class Stats, class Allocator>
+const T &InstrumentedCircularBuffer<T, Stats, Allocator>::front() const {
+    return ring.front();
+}
+
+// Reference to the last element
+template <class T, class Stats, class Allocator>
+T &InstrumentedCircularBuffer<T, Stats, Allocator>::back() {
+    return ring.back();
+}
+
+template <class T, class Stats, class Allocator>
+const T &InstrumentedCircularBuffer<T, Stats, Allocator>::back() const {
+    return ring.back();
+}
+
+// Returns the number of elements stored in the buffer
+template <class T, class Stats, class Allocator>
+int InstrumentedCircularBuffer<T, Stats, Allocator>::size() const {
+    return ring.size();
+}
+
+// Checks if the buffer is empty
+template <class T, class Stats, class Allocator>
+bool InstrumentedCircularBuffer<T, Stats, Allocator>::empty() const {
+    return ring.empty();
+}
+
+// Checks if the buffer is full (size == capacity)
+template <class T, class Stats, class Allocator>
+bool InstrumentedCircularBuffer<T, Stats, Allocator>::full() const {
+    return ring.full();
+}
+
+// Returns the number of free slots in the buffer
+template <class T, class Stats, class Allocator>
+int InstrumentedCircularBuffer<T, Stats, Allocator>::reserve() const {
+    return ring.reserve();
+}
+
+// Returns the capacity of the buffer
+template <class T, class Stats, class Allocator>
+int InstrumentedCircularBuffer<T, Stats, Allocator>::capacity() const {
+    return ring.capacity();
+}
+
+// Adds an element to the end of the buffer
+// If the buffer is full, the first element is overwritten
+template <class T, class Stats, class Allocator>
+void InstrumentedCircularBuffer<T, Stats, Allocator>::push_back(const value_type &item) {
+    bool overwrite = ring.full();
+    ring.push_back(item);
+    counters.on_push(1, overwrite, ring.size());
+}
+
+template <class T, class Stats, class Allocator>
+void InstrumentedCircularBuffer<T, Stats, Allocator>::push_back(value_type &&item) {
+    bool overwrite = ring.full();
+    ring.push_back(std::move(item));
+    counters.on_push(1, overwrite, ring.size());
+}
+
+// Adds a new element before the first element of the buffer
+// If the buffer is full, the last element is overwritten
+template <class T, class Stats, class Allocator>
+void InstrumentedCircularBuffer<T, Stats, Allocator>::push_front(const value_type &item) {
+    bool overwrite = ring.full();
+    ring.push_front(item);
+    counters.on_push(1, overwrite, ring.size());
+}
+
+template <class T, class Stats, class Allocator>
+void InstrumentedCircularBuffer<T, Stats, Allocator>::push_front(value_type &&item) {
+    bool overwrite = ring.full();
+    ring.push_front(std::move(item));
+    counters.on_push(1, overwrite, ring.size());
+}
+
+// Constructs an element in place after the last element
+template <class T, class Stats, class Allocator>
+template <class... Args>
+T &InstrumentedCircularBuffer<T, Stats, Allocator>::emplace_back(Args &&...args) {
+    bool overwrite = ring.full();
+    value_type &item = ring.emplace_back(std::forward<Args>(args)...);
+    counters.on_push(1, overwrite, ring.size());
+    return item;
+}
+
+// Constructs an element in place before the first element
+template <class T, class Stats, class Allocator>
+template <class... Args>
+T &InstrumentedCircularBuffer<T, Stats, Allocator>::emplace_front(Args &&...args) {
+    bool overwrite = ring.full();
+    value_type &item = ring.emplace_front(std::forward<Args>(args)...);
+    counters.on_push(1, overwrite, ring.size());
+    return item;
+}
+
+// Adds n elements to the end of the buffer
+// Equivalent to calling push_back for data[0], ..., data[n - 1]
+template <class T, class Stats, class Allocator>
+void InstrumentedCircularBuffer<T, Stats, Allocator>::push_back(const value_type *data, int n) {
+    int overwritten = ring.size() + n - ring.capacity();
+    ring.push_back(data, n);
+    if (n > 0) {
+        counters.on_push(n, overwritten > 0 ? overwritten : 0, ring.size());
+    }
+}
+
+// Removes the last element of the buffer
+template <class T, class Stats, class Allocator>
+void InstrumentedCircularBuffer<T, Stats, Allocator>::pop_back() {
+    ring.pop_back();
+    counters.on_pop(1, ring.size());
+}
+
+// Removes the first element of the buffer
+template <class T, class Stats, class Allocator>
+void InstrumentedCircularBuffer<T, Stats, Allocator>::pop_front() {
+    ring.pop_front();
+    counters.on_pop(1, ring.size());
+}
+
+// Removes the first n elements of the buffer and copies them into out
+template <class T, class Stats, class Allocator>
+void InstrumentedCircularBuffer<T, Stats, Allocator>::pop_front(value_type *out, int n) {
+    ring.pop_front(out, n);
+    if (n > 0) {
+        counters.on_pop(n, ring.size());
+    }
+}
+
+// Clears the buffer; counted as popping every element
+template <class T, class Stats, class Allocator>
+void InstrumentedCircularBuffer<T, Stats, Allocator>::clear() {
+    int n = ring.size();
+    ring.clear();
+    if (n > 0) {
+        counters.on_pop(n, 0);
+    }
+}
+
+// Iterators over the elements in logical order
+template <class T, class Stats, class Allocator>
+typename InstrumentedCircularBuffer<T, Stats, Allocator>::iterator InstrumentedCircularBuffer<T, Stats, Allocator>::begin() {
+    return ring.begin();
+}
+
+template <class T, class Stats, class Allocator>
+typename InstrumentedCircularBuffer<T, Stats, Allocator>::iterator InstrumentedCircularBuffer<T, Stats, Allocator>::end() {
+    return ring.end();
+}
+
+template <class T, class Stats, class Allocator>
+typename InstrumentedCircularBuffer<T, Stats, Allocator>::const_iterator
+InstrumentedCircularBuffer<T, Stats, Allocator>::begin() const {
+    return ring.begin();
+}
+
+template <class T, class Stats, class Allocator>
+typename InstrumentedCircularBuffer<T, Stats, Allocator>::const_iterator
+InstrumentedCircularBuffer<T, Stats, Allocator>::end() const {
+    return ring.end();
+}
+
+// Returns the usage statistics
+template <class T, class Stats, class Allocator>
+const Stats &InstrumentedCircularBuffer<T, Stats, Allocator>::stats() const {
+    return counters;
+}
+
+// Zeroes the usage statistics; only from the thread that uses the buffer
+template <class T, class Stats, class Allocator>
+void InstrumentedCircularBuffer<T, Stats, Allocator>::reset_stats() {
+    counters.reset(ring.size());
+}
+
+// Returns the underlying buffer
+template <class T, class Stats, class Allocator>
+const CircularBuffer<T, Allocator> &InstrumentedCircularBuffer<T, Stats, Allocator>::buffer() const {
+    return ring;
+}
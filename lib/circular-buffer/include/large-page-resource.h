@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <mutex>
+
+// Kind of pages behind an allocation of LargePageResource
+enum class PageBacking {
+    Regular,       // Base pages of the system
+    Transparent,   // Transparent huge pages, confirmed by the kernel after the first touch
+    Explicit       // Preallocated huge pages from MAP_HUGETLB
+};
+
+// Options of LargePageResource
+struct LargePageOptions {
+    bool huge_pages = true;   // Try MAP_HUGETLB, then transparent huge pages
+    int numa_node = -1;       // Bind the memory to this NUMA node, -1 for no binding
+    bool lock = false;        // mlock the memory so that it never page-faults
+};
+
+// What the last allocation of a LargePageResource actually obtained
+struct PageBackingInfo {
+    PageBacking backing = PageBacking::Regular;
+    std::size_t page_size = 0;   // Size of the pages backing the start of the mapping
+    bool numa_bound = false;     // The NUMA binding succeeded
+    bool locked = false;         // The memory is locked and faulted in
+};
+
+// Memory resource for very large rings, to be used with PmrCircularBuffer.
+// Every allocation is a separate anonymous mapping. Huge pages, NUMA
+// binding and locking are attempted in turn and silently fall back when the
+// system refuses them; last_backing() reports what was obtained. When
+// transparent huge pages are requested, the first page is touched to find
+// out whether the kernel actually used one. The resource may be shared
+// between threads. Linux only; elsewhere the memory comes from the global
+// operator new.
+class LargePageResource : public std::pmr::memory_resource {
+private:
+    LargePageOptions options;       // Requested backing
+    std::size_t granule;            // Allocation sizes are rounded up to a multiple of this
+    std::size_t base_page;          // Size of the regular pages of the system
+    mutable std::mutex last_mutex;  // Guards last
+    PageBackingInfo last;           // Backing of the last allocation
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+public:
+    // Constructs a resource with the given options
+    explicit LargePageResource(const LargePageOptions& options = LargePageOptions());
+
+    LargePageResource(const LargePageResource&) = delete;
+    LargePageResource& operator=(const LargePageResource&) = delete;
+
+    // Returns the options given at construction
+    const LargePageOptions& get_options() const;
+
+    // Returns what the last allocation actually obtained
+    PageBackingInfo last_backing() const;
+
+    // Returns the default huge page size of the system, 0 if unknown
+    static std::size_t huge_page_size();
+};
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "circular-buffer.h"
+
+// Circular buffer whose capacity is rounded up to a power of two.
+// Positions are free-running unsigned counters reduced with a bitmask,
+// so no division is needed and size is simply tail - head.
+class MaskedCircularBuffer {
+public:
+    typedef char value_type;
+
+private:
+    value_type* buffer;    // Pointer to the buffer array
+    unsigned cap;          // Capacity of the buffer, zero or a power of two
+    unsigned mask;         // cap - 1
+    unsigned head;         // Counter of the first element
+    unsigned tail;         // Counter one past the last element
+
+public:
+    // Default constructor
+    MaskedCircularBuffer();
+
+    // Destructor
+    ~MaskedCircularBuffer();
+
+    // Copy constructor
+    MaskedCircularBuffer(const MaskedCircularBuffer& cb);
+
+    // Constructs a buffer with at least the given capacity, rounded up to a power of two
+    explicit MaskedCircularBuffer(int capacity);
+
+    // Assignment operator
+    MaskedCircularBuffer& operator=(const MaskedCircularBuffer& cb);
+
+    // Access by index without bounds checking
+    value_type& operator[](int i);
+    const value_type& operator[](int i) const;
+
+    // Access by index with bounds checking
+    value_type& at(int i);
+    const value_type& at(int i) const;
+
+    // Reference to the first element
+    value_type& front();
+    const value_type& front() const;
+
+    // Reference to the last element
+    value_type& back();
+    const value_type& back() const;
+
+    // Returns the number of elements stored in the buffer
+    int size() const;
+
+    // Checks if the buffer is empty
+    bool empty() const;
+
+    // Checks if the buffer is full (size == capacity)
+    bool full() const;
+
+    // Returns the number of free slots in the buffer
+    int reserve() const;
+
+    // Returns the capacity of the buffer
+    int capacity() const;
+
+    // Swaps the contents of the buffer with another buffer
+    void swap(MaskedCircularBuffer& cb);
+
+    // Adds an element to the end of the buffer
+    // If the buffer is full, the first element is overwritten
+    void push_back(const value_type& item = value_type());
+
+    // Adds a new element before the first element of the buffer
+    // If the buffer is full, the last element is overwritten
+    void push_front(const value_type& item = value_type());
+
+    // Removes the last element of the buffer
+    void pop_back();
+
+    // Removes the first element of the buffer
+    void pop_front();
+
+    // Clears the buffer
+    void clear();
+};
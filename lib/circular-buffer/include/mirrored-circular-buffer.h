@@ -0,0 +1,377 @@
+#pragma once
+
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "mirrored-mapping.h"
+
+// Circular buffer backed by a MirroredMapping: the storage is followed in
+// virtual memory by a second view of itself, so any window of up to
+// capacity() elements is contiguous. linearize() and contiguous_view()
+// are O(1) and never copy. The capacity is rounded up so that the storage
+// covers a whole number of pages. Linux only; T must be trivially copyable.
+template <class T = char>
+class MirroredCircularBuffer {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "MirroredCircularBuffer requires a trivially copyable value_type");
+
+public:
+    typedef T value_type;
+
+private:
+    MirroredMapping mapping;   // Doubled storage
+    value_type* buffer;        // Start of the storage, valid for 2 * cap elements
+    int cap;                   // Capacity of the buffer
+    int start;                 // Index of the first element, always below cap
+    int count;                 // Number of elements in the buffer
+
+public:
+    // Default constructor
+    MirroredCircularBuffer();
+
+    // Constructs a buffer with at least the given capacity
+    explicit MirroredCircularBuffer(int capacity);
+
+    MirroredCircularBuffer(const MirroredCircularBuffer&) = delete;
+    MirroredCircularBuffer& operator=(const MirroredCircularBuffer&) = delete;
+
+    // Move constructor and assignment
+    MirroredCircularBuffer(MirroredCircularBuffer&& cb) noexcept;
+    MirroredCircularBuffer& operator=(MirroredCircularBuffer&& cb) noexcept;
+
+    // Access by index without bounds checking
+    value_type& operator[](int i);
+    const value_type& operator[](int i) const;
+
+    // Access by index with bounds checking
+    value_type& at(int i);
+    const value_type& at(int i) const;
+
+    // Reference to the first element
+    value_type& front();
+    const value_type& front() const;
+
+    // Reference to the last element
+    value_type& back();
+    const value_type& back() const;
+
+    // Returns a pointer to the first element; all elements follow it contiguously
+    value_type* linearize();
+
+    // Always true: the elements are contiguous in virtual memory
+    bool is_linearized() const;
+
+    // Returns a pointer to len contiguous elements starting at element pos
+    const value_type* contiguous_view(int pos, int len) const;
+
+    // Returns the number of elements stored in the buffer
+    int size() const;
+
+    // Checks if the buffer is empty
+    bool empty() const;
+
+    // Checks if the buffer is full (size == capacity)
+    bool full() const;
+
+    // Returns the number of free slots in the buffer
+    int reserve() const;
+
+    // Returns the capacity of the buffer
+    int capacity() const;
+
+    // Swaps the contents of the buffer with another buffer
+    void swap(MirroredCircularBuffer& cb) noexcept;
+
+    // Adds an element to the end of the buffer
+    // If the buffer is full, the first element is overwritten
+    void push_back(const value_type& item = value_type());
+
+    // Adds a new element before the first element of the buffer
+    // If the buffer is full, the last element is overwritten
+    void push_front(const value_type& item = value_type());
+
+    // Adds n elements to the end of the buffer with a single copy
+    // Equivalent to calling push_back for data[0], ..., data[n - 1]
+    void push_back(const value_type* data, int n);
+
+    // Removes the last element of the buffer
+    void pop_back();
+
+    // Removes the first element of the buffer
+    void pop_front();
+
+    // Removes the first n elements of the buffer and copies them into out
+    void pop_front(value_type* out, int n);
+
+    // Clears the buffer
+    void clear();
+};
+
+// Default constructor
+template <class T>
+MirroredCircularBuffer<T>::MirroredCircularBuffer()
+    : buffer(nullptr), cap(0), start(0), count(0) {}
+
+// Constructs a buffer with at least the given capacity
+template <class T>
+MirroredCircularBuffer<T>::MirroredCircularBuffer(int capacity)
+    : buffer(nullptr), cap(0), start(0), count(0) {
+    if (capacity < 0) {
+        throw std::invalid_argument("Capacity must be non-negative");
+    }
+    mapping = MirroredMapping(static_cast<std::size_t>(capacity) * sizeof(value_type), sizeof(value_type));
+    buffer = reinterpret_cast<value_type*>(mapping.data());
+    cap = static_cast<int>(mapping.size() / sizeof(value_type));
+}
+
+// Move constructor and assignment
+template <class T>
+MirroredCircularBuffer<T>::MirroredCircularBuffer(MirroredCircularBuffer &&cb) noexcept
+    : buffer(nullptr), cap(0), start(0), count(0) {
+    swap(cb);
+}
+
+template <class T>
+MirroredCircularBuffer<T> &MirroredCircularBuffer<T>::operator=(MirroredCircularBuffer &&cb) noexcept {
+    MirroredCircularBuffer moved(std::move(cb));
+    swap(moved);
+    return *this;
+}
+
+// Access by index without bounds checking
+template <class T>
+T &MirroredCircularBuffer<T>::operator[](int i) {
+    return buffer[start + i];
+}
+
+template <class T>
+const T &MirroredCircularBuffer<T>::operator[](int i) const {
+    return buffer[start + i];
+}
+
+// Access by index with bounds checking
+template <class T>
+T &MirroredCircularBuffer<T>::at(int i) {
+    if (i < 0 || i >= count) {
+        throw std::out_of_range("Index out of range");
+    }
+    return buffer[start + i];
+}
+
+template <class T>
+const T &MirroredCircularBuffer<T>::at(int i) const {
+    if (i < 0 || i >= count) {
+        throw std::out_of_range("Index out of range");
+    }
+    return buffer[start + i];
+}
+
+// Reference to the first element
+template <class T>
+T &MirroredCircularBuffer<T>::front() {
+    if (empty()) {
+        throw std::runtime_error("Buffer is empty");
+    }
+    return buffer[start];
+}
+
+template <class T>
+const T &MirroredCircularBuffer<T>::front() const {
+    if (empty()) {
+        throw std::runtime_error("Buffer is empty");
+    }
+    return buffer[start];
+}
+
+// Reference to the last element
+template <class T>
+T &MirroredCircularBuffer<T>::back() {
+    if (empty()) {
+        throw std::runtime_error("Buffer is empty");
+    }
+    return buffer[start + count - 1];
+}
+
+template <class T>
+const T &MirroredCircularBuffer<T>::back() const {
+    if (empty()) {
+        throw std::runtime_error("Buffer is empty");
+    }
+    return buffer[start + count - 1];
+}
+
+// Returns a pointer to the first element; all elements follow it contiguously
+template <class T>
+T *MirroredCircularBuffer<T>::linearize() {
+    return buffer + start;
+}
+
+// Always true: the elements are contiguous in virtual memory
+template <class T>
+bool MirroredCircularBuffer<T>::is_linearized() const {
+    return true;
+}
+
+// Returns a pointer to len contiguous elements starting at element pos
+template <class T>
+const T *MirroredCircularBuffer<T>::contiguous_view(int pos, int len) const {
+    if (pos < 0 || len < 0 || pos + len > count) {
+        throw std::out_of_range("View out of range");
+    }
+    return buffer + start + pos;
+}
+
+// Returns the number of elements stored in the buffer
+template <class T>
+int MirroredCircularBuffer<T>::size() const {
+    return count;
+}
+
+// Checks if the buffer is empty
+template <class T>
+bool MirroredCircularBuffer<T>::empty() const {
+    return count == 0;
+}
+
+// Checks if the buffer is full (size == capacity)
+template <class T>
+bool MirroredCircularBuffer<T>::full() const {
+    return count == cap;
+}
+
+// Returns the number of free slots in the buffer
+template <class T>
+int MirroredCircularBuffer<T>::reserve() const {
+    return cap - count;
+}
+
+// Returns the capacity of the buffer
+template <class T>
+int MirroredCircularBuffer<T>::capacity() const {
+    return cap;
+}
+
+// Swaps the contents of the buffer with another buffer
+template <class T>
+void MirroredCircularBuffer<T>::swap(MirroredCircularBuffer &cb) noexcept {
+    mapping.swap(cb.mapping);
+    std::swap(buffer, cb.buffer);
+    std::swap(cap, cb.cap);
+    std::swap(start, cb.start);
+    std::swap(count, cb.count);
+}
+
+// Adds an element to the end of the buffer
+// If the buffer is full, the first element is overwritten
+template <class T>
+void MirroredCircularBuffer<T>::push_back(const value_type &item) {
+    if (cap == 0) {
+        throw std::runtime_error("Buffer capacity is zero");
+    }
+    buffer[start + count] = item;
+    if (full()) {
+        start = start + 1 == cap ? 0 : start + 1;
+    } else {
+        ++count;
+    }
+}
+
+// Adds a new element before the first element of the buffer
+// If the buffer is full, the last element is overwritten
+template <class T>
+void MirroredCircularBuffer<T>::push_front(const value_type &item) {
+    if (cap == 0) {
+        throw std::runtime_error("Buffer capacity is zero");
+    }
+    start = start == 0 ? cap - 1 : start - 1;
+    buffer[start] = item;
+    if (!full()) {
+        ++count;
+    }
+}
+
+// Adds n elements to the end of the buffer with a single copy
+// Equivalent to calling push_back for data[0], ..., data[n - 1]
+template <class T>
+void MirroredCircularBuffer<T>::push_back(const value_type *data, int n) {
+    if (n < 0) {
+        throw std::invalid_argument("n must be non-negative");
+    }
+    if (n == 0) {
+        return;
+    }
+    if (cap == 0) {
+        throw std::runtime_error("Buffer capacity is zero");
+    }
+    if (n >= cap) {
+        // Only the last cap elements survive
+        std::memcpy(buffer, data + (n - cap), cap * sizeof(value_type));
+        start = 0;
+        count = cap;
+        return;
+    }
+    int tail = start + count;
+    if (tail >= cap) {
+        tail -= cap;
+    }
+    // The mirror absorbs the wrap, so one copy is enough
+    std::memcpy(buffer + tail, data, n * sizeof(value_type));
+    int overflow = count + n - cap;
+    if (overflow > 0) {
+        start += overflow;
+        if (start >= cap) {
+            start -= cap;
+        }
+        count = cap;
+    } else {
+        count += n;
+    }
+}
+
+// Removes the last element of the buffer
+template <class T>
+void MirroredCircularBuffer<T>::pop_back() {
+    if (empty()) {
+        throw std::runtime_error("Buffer is empty");
+    }
+    --count;
+}
+
+// Removes the first element of the buffer
+template <class T>
+void MirroredCircularBuffer<T>::pop_front() {
+    if (empty()) {
+        throw std::runtime_error("Buffer is empty");
+    }
+    start = start + 1 == cap ? 0 : start + 1;
+    --count;
+}
+
+// Removes the first n elements of the buffer and copies them into out
+template <class T>
+void MirroredCircularBuffer<T>::pop_front(value_type *out, int n) {
+    if (n < 0) {
+        throw std::invalid_argument("n must be non-negative");
+    }
+    if (n > count) {
+        throw std::runtime_error("Not enough elements in the buffer");
+    }
+    if (n == 0) {
+        return;
+    }
+    std::memcpy(out, buffer + start, n * sizeof(value_type));
+    start += n;
+    if (start >= cap) {
+        start -= cap;
+    }
+    count -= n;
+}
+
+// Clears the buffer
+template <class T>
+void MirroredCircularBuffer<T>::clear() {
+    start = 0;
+    count = 0;
+}
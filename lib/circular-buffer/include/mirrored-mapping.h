@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+
+// Maps the same physical pages twice, back to back, so that
+// data()[i] and data()[i + size()] are the same byte for every i < size().
+// Linux only (memfd + two mmap calls); elsewhere the constructor throws.
+class MirroredMapping {
+private:
+    unsigned char* base;   // Start of the doubled mapping
+    std::size_t length;    // Length of one copy in bytes
+
+public:
+    // Creates an empty mapping
+    MirroredMapping();
+
+    // Maps at least min_bytes, rounded up to a multiple of unit and of the page size
+    MirroredMapping(std::size_t min_bytes, std::size_t unit);
+
+    // Destructor
+    ~MirroredMapping();
+
+    MirroredMapping(const MirroredMapping&) = delete;
+    MirroredMapping& operator=(const MirroredMapping&) = delete;
+
+    // Move constructor and assignment
+    MirroredMapping(MirroredMapping&& other) noexcept;
+    MirroredMapping& operator=(MirroredMapping&& other) noexcept;
+
+    // Start of the mapping; valid for 2 * size() bytes
+    unsigned char* data() const;
+
+    // Length of one copy in bytes
+    std::size_t size() const;
+
+    // Swaps two mappings
+    void swap(MirroredMapping& other) noexcept;
+
+    // Returns the system page size
+    static std::size_t page_size();
+};
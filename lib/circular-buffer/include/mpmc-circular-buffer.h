@@ -0,0 +1,257 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+// Bounded lock-free queue for any number of producer and consumer threads
+// (Dmitry Vyukov's design). Every slot carries a sequence number telling
+// whether it is free or filled for the current lap, so producers and
+// consumers only contend on their own position counter.
+// The capacity is rounded up to a power of two, at least 2: with a single
+// slot a filled sequence number would look free for the next lap. None of the try_* calls
+// block or throw; constructing and moving elements must not throw either,
+// since a claimed slot cannot be handed back.
+template <class T, class Allocator = std::allocator<T>>
+class MpmcCircularBuffer {
+public:
+    typedef T value_type;
+    typedef Allocator allocator_type;
+
+private:
+    static const std::size_t cache_line = 64;
+
+    struct Slot {
+        std::atomic<std::size_t> sequence;
+        alignas(T) unsigned char storage[sizeof(T)];
+
+        T* value() { return reinterpret_cast<T*>(storage); }
+    };
+
+    typedef typename std::allocator_traits<Allocator>::template rebind_alloc<Slot> slot_allocator;
+    typedef std::allocator_traits<slot_allocator> slot_traits;
+
+    slot_allocator alloc;      // Allocator of the slot array
+    Slot* slots;               // Slot array
+    std::size_t cap;           // Capacity of the queue, zero or a power of two above 1
+    std::size_t mask;          // cap - 1
+
+    // Position of the next slot to fill
+    alignas(cache_line) std::atomic<std::size_t> enqueue_pos;
+
+    // Position of the next slot to drain
+    alignas(cache_line) std::atomic<std::size_t> dequeue_pos;
+
+    // Claims up to n consecutive slots at the position in counter whose sequence
+    // equals position + offset; returns the first claimed position and sets n
+    std::size_t claim(std::atomic<std::size_t>& counter, std::size_t offset, int& n);
+
+public:
+    // Constructs a queue with at least the given capacity, rounded up to a power of two
+    explicit MpmcCircularBuffer(int capacity, const Allocator& allocator = Allocator());
+
+    // Destructor
+    ~MpmcCircularBuffer();
+
+    MpmcCircularBuffer(const MpmcCircularBuffer&) = delete;
+    MpmcCircularBuffer& operator=(const MpmcCircularBuffer&) = delete;
+
+    // Constructs an element at the end of the queue
+    // Returns false if the queue is full
+    template <class... Args>
+    bool try_emplace(Args&&... args);
+
+    // Adds an element to the end of the queue
+    // Returns false if the queue is full
+    bool try_push(const value_type& item);
+    bool try_push(value_type&& item);
+
+    // Removes the first element of the queue into item
+    // Returns false if the queue is empty
+    bool try_pop(value_type& item);
+
+    // Adds up to n elements from data with a single position update
+    // Returns the number of elements added, a prefix of data
+    int try_push_n(const value_type* data, int n);
+
+    // Removes up to n elements into out with a single position update
+    // Returns the number of elements removed
+    int try_pop_n(value_type* out, int n);
+
+    // Returns the number of stored elements; exact only when all threads are idle
+    int size() const;
+
+    // Checks if the queue is empty; exact only when all threads are idle
+    bool empty() const;
+
+    // Returns the capacity of the queue
+    int capacity() const;
+};
+
+// Constructs a queue with at least the given capacity, rounded up to a power of two
+template <class T, class Allocator>
+MpmcCircularBuffer<T, Allocator>::MpmcCircularBuffer(int capacity, const Allocator &allocator)
+    : alloc(allocator), slots(nullptr), cap(0), mask(0), enqueue_pos(0), dequeue_pos(0) {
+    if (capacity < 0) {
+        throw std::invalid_argument("Capacity must be non-negative");
+    }
+    if (capacity > (1 << 30)) {
+        throw std::invalid_argument("Capacity is too large");
+    }
+    if (capacity == 0) {
+        return;
+    }
+    cap = 2;
+    while (cap < static_cast<std::size_t>(capacity)) {
+        cap <<= 1;
+    }
+    mask = cap - 1;
+    slots = slot_traits::allocate(alloc, cap);
+    for (std::size_t i = 0; i < cap; ++i) {
+        ::new (static_cast<void*>(&slots[i].sequence)) std::atomic<std::size_t>(i);
+    }
+}
+
+// Destructor
+template <class T, class Allocator>
+MpmcCircularBuffer<T, Allocator>::~MpmcCircularBuffer() {
+    if (!slots) {
+        return;
+    }
+    std::size_t head = dequeue_pos.load(std::memory_order_relaxed);
+    std::size_t tail = enqueue_pos.load(std::memory_order_relaxed);
+    for (std::size_t pos = head; pos != tail; ++pos) {
+        slots[pos & mask].value()->~T();
+    }
+    slot_traits::deallocate(alloc, slots, cap);
+}
+
+// Claims up to n consecutive slots at the position in counter whose sequence
+// equals position + offset; returns the first claimed position and sets n
+template <class T, class Allocator>
+std::size_t MpmcCircularBuffer<T, Allocator>::claim(std::atomic<std::size_t> &counter,
+                                                    std::size_t offset, int &n) {
+    std::size_t pos = counter.load(std::memory_order_relaxed);
+    for (;;) {
+        // Count the ready slots; they cannot change until someone moves counter past them
+        int ready = 0;
+        while (ready < n && static_cast<std::size_t>(ready) < cap) {
+            std::size_t seq = slots[(pos + ready) & mask].sequence.load(std::memory_order_acquire);
+            if (seq != pos + ready + offset) {
+                break;
+            }
+            ++ready;
+        }
+        if (ready == 0) {
+            std::size_t seq = slots[pos & mask].sequence.load(std::memory_order_acquire);
+            std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(seq - (pos + offset));
+            if (diff < 0) {
+                // The slot still belongs to the previous lap: full or empty
+                n = 0;
+                return pos;
+            }
+            // Another thread claimed this position, retry from the fresh one
+            pos = counter.load(std::memory_order_relaxed);
+            continue;
+        }
+        if (counter.compare_exchange_weak(pos, pos + ready, std::memory_order_relaxed)) {
+            n = ready;
+            return pos;
+        }
+    }
+}
+
+// Constructs an element at the end of the queue
+// Returns false if the queue is full
+template <class T, class Allocator>
+template <class... Args>
+bool MpmcCircularBuffer<T, Allocator>::try_emplace(Args &&...args) {
+    if (cap == 0) {
+        return false;
+    }
+    int n = 1;
+    std::size_t pos = claim(enqueue_pos, 0, n);
+    if (n == 0) {
+        return false;
+    }
+    Slot &slot = slots[pos & mask];
+    ::new (static_cast<void*>(slot.storage)) T(std::forward<Args>(args)...);
+    slot.sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+// Adds an element to the end of the queue
+// Returns false if the queue is full
+template <class T, class Allocator>
+bool MpmcCircularBuffer<T, Allocator>::try_push(const value_type &item) {
+    return try_emplace(item);
+}
+
+template <class T, class Allocator>
+bool MpmcCircularBuffer<T, Allocator>::try_push(value_type &&item) {
+    return try_emplace(std::move(item));
+}
+
+// Removes the first element of the queue into item
+// Returns false if the queue is empty
+template <class T, class Allocator>
+bool MpmcCircularBuffer<T, Allocator>::try_pop(value_type &item) {
+    return try_pop_n(&item, 1) == 1;
+}
+
+// Adds up to n elements from data with a single position update
+// Returns the number of elements added, a prefix of data
+template <class T, class Allocator>
+int MpmcCircularBuffer<T, Allocator>::try_push_n(const value_type *data, int n) {
+    if (cap == 0 || n <= 0) {
+        return 0;
+    }
+    std::size_t pos = claim(enqueue_pos, 0, n);
+    for (int i = 0; i < n; ++i) {
+        Slot &slot = slots[(pos + i) & mask];
+        ::new (static_cast<void*>(slot.storage)) T(data[i]);
+        slot.sequence.store(pos + i + 1, std::memory_order_release);
+    }
+    return n;
+}
+
+// Removes up to n elements into out with a single position update
+// Returns the number of elements removed
+template <class T, class Allocator>
+int MpmcCircularBuffer<T, Allocator>::try_pop_n(value_type *out, int n) {
+    if (cap == 0 || n <= 0) {
+        return 0;
+    }
+    std::size_t pos = claim(dequeue_pos, 1, n);
+    for (int i = 0; i < n; ++i) {
+        Slot &slot = slots[(pos + i) & mask];
+        T *value = slot.value();
+        out[i] = std::move(*value);
+        value->~T();
+        slot.sequence.store(pos + i + cap, std::memory_order_release);
+    }
+    return n;
+}
+
+// Returns the number of stored elements; exact only when all threads are idle
+template <class T, class Allocator>
+int MpmcCircularBuffer<T, Allocator>::size() const {
+    std::size_t head = dequeue_pos.load(std::memory_order_acquire);
+    std::size_t tail = enqueue_pos.load(std::memory_order_acquire);
+    return tail > head ? static_cast<int>(tail - head) : 0;
+}
+
+// Checks if the queue is empty; exact only when all threads are idle
+template <class T, class Allocator>
+bool MpmcCircularBuffer<T, Allocator>::empty() const {
+    return size() == 0;
+}
+
+// Returns the capacity of the queue
+template <class T, class Allocator>
+int MpmcCircularBuffer<T, Allocator>::capacity() const {
+    return static_cast<int>(cap);
+}
@@ -0,0 +1,435 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+#include "circular-buffer.h"
+
+// Overflow policies for OverflowCircularBuffer. A policy declares whether a
+// push into a full buffer overwrites the element at the other end; if it does,
+// evict() sees that element just before it is overwritten.
+
+// A push into a full buffer overwrites the element at the other end, as CircularBuffer does
+struct OverwriteOldest {
+    static constexpr bool overwrites = true;
+
+    template <class T>
+    void evict(T&) {}
+};
+
+// A push into a full buffer fails and leaves the buffer unchanged
+struct RejectNew {
+    static constexpr bool overwrites = false;
+};
+
+// Like OverwriteOldest, but hands every evicted element to a callback first;
+// the callback may move from the element but must not touch the buffer
+template <class F>
+struct EvictCallback {
+    static constexpr bool overwrites = true;
+
+    F callback;
+
+    explicit EvictCallback(F f = F()) : callback(std::move(f)) {}
+
+    template <class T>
+    void evict(T& item) { callback(item); }
+};
+
+// Circular buffer whose behaviour on overflow is fixed at compile time by
+// Policy, so a push costs the same as in CircularBuffer plus one counter
+// update on overflow. Every element lost to overflow, whether evicted or
+// rejected, is counted in dropped().
+// A producer that should block until a consumer makes room needs that
+// consumer on another thread; use BlockingCircularBuffer over
+// SpscCircularBuffer or MpmcCircularBuffer for that.
+template <class T = char, class Policy = OverwriteOldest, class Allocator = std::allocator<T>>
+class OverflowCircularBuffer {
+public:
+    typedef T value_type;
+    typedef Policy policy_type;
+    typedef Allocator allocator_type;
+    typedef typename CircularBuffer<T, Allocator>::iterator iterator;
+    typedef typename CircularBuffer<T, Allocator>::const_iterator const_iterator;
+
+private:
+    CircularBuffer<T, Allocator> ring;   // Storage
+    Policy overflow;                     // What a push into a full buffer does
+    std::uint64_t dropped_count;         // Elements evicted or rejected so far
+
+    // Makes room for one element at the back or the front
+    // Returns false if the policy rejects the new element
+    bool make_room(bool at_back);
+
+public:
+    // Constructs a buffer with a given capacity and overflow policy
+    explicit OverflowCircularBuffer(int capacity = 0, const Policy& policy = Policy(),
+                                    const allocator_type& allocator = allocator_type());
+
+    // Access by index without bounds checking
+    value_type& operator[](int i);
+    const value_type& operator[](int i) const;
+
+    // Access by index with bounds checking
+    value_type& at(int i);
+    const value_type& at(int i) const;
+
+    // Reference to the first element
+    value_type& front();
+    const value_type& front() const;
+
+    // Reference to the last element
+    value_type& back();
+    const value_type& back() const;
+
+    // Returns the number of elements stored in the buffer
+    int size() const;
+
+    // Checks if the buffer is empty
+    bool empty() const;
+
+    // Checks if the buffer is full (size == capacity)
+    bool full() const;
+
+    // Returns the number of free slots in the buffer
+    int reserve() const;
+
+    // Returns the capacity of the buffer
+    int capacity() const;
+
+    // Returns the number of elements evicted or rejected since construction or reset_dropped()
+    std::uint64_t dropped() const;
+
+    // Resets the dropped counter to zero
+    void reset_dropped();
+
+    // Returns the overflow policy
+    Policy& policy();
+    const Policy& policy() const;
+
+    // Adds an element to the end of the buffer
+    // Returns false if the buffer is full and the policy rejects the element
+    bool push_back(const value_type& item);
+    bool push_back(value_type&& item);
+
+    // Adds a new element before the first element of the buffer
+    // Returns false if the buffer is full and the policy rejects the element
+    bool push_front(const value_type& item);
+    bool push_front(value_type&& item);
+
+    // Constructs an element in place after the last element
+    // Returns false if the buffer is full and the policy rejects the element
+    template <class... Args>
+    bool emplace_back(Args&&... args);
+
+    // Constructs an element in place before the first element
+    // Returns false if the buffer is full and the policy rejects the element
+    template <class... Args>
+    bool emplace_front(Args&&... args);
+
+    // Adds n elements to the end of the buffer
+    // Returns the number of elements stored: a prefix of data if the policy rejects, otherwise n
+    int push_back(const value_type* data, int n);
+
+    // Removes the last element of the buffer
+    void pop_back();
+
+    // Removes the first element of the buffer
+    void pop_front();
+
+    // Removes the first n elements of the buffer and copies them into out
+    void pop_front(value_type* out, int n);
+
+    // Clears the buffer; the dropped counter is kept
+    void clear();
+
+    // Iterators over the elements in logical order
+    iterator begin();
+    iterator end();
+    const_iterator begin() const;
+    const_iterator end() const;
+
+    // Returns the underlying buffer
+    const CircularBuffer<T, Allocator>& buffer() const;
+};
+
+// Constructs a buffer with a given capacity and overflow policy
+template <class T, class Policy, class Allocator>
+OverflowCircularBuffer<T, Policy, Allocator>::OverflowCircularBuffer(int capacity, const Policy &policy,
+                                                                     const allocator_type &allocator)
+    : ring(capacity, allocator), overflow(policy), dropped_count(0) {}
+
+// Makes room for one element at the back or the front
+// Returns false if the policy rejects the new element
+template <class T, class Policy, class Allocator>
+bool OverflowCircularBuffer<T, Policy, Allocator>::make_room(bool at_back) {
+    if (!ring.full()) {
+        return true;
+    }
+    if constexpr (Policy::overwrites) {
+        if (ring.capacity() == 0) {
+            throw std::runtime_error("Buffer capacity is zero");
+        }
+        // The push overwrites the element at the other end
+        overflow.evict(ring[at_back ? 0 : ring.size() - 1]);
+        ++dropped_count;
+        return true;
+    } else {
+        (void)at_back;
+        ++dropped_count;
+        return false;
+    }
+}
+
+// Access by index without bounds checking
+template <class T, class Policy, class Allocator>
+T &OverflowCircularBuffer<T, Policy, Allocator>::operator[](int i) {
+    return ring[i];
+}
+
+template <class T, class Policy, class Allocator>
+const T &OverflowCircularBuffer<T, Policy, Allocator>::operator[](int i) const {
+    return ring[i];
+}
+
+// Access by index with bounds checking
+template <class T, class Policy, class Allocator>
+T &OverflowCircularBuffer<T, Policy, Allocator>::at(int i) {
+    return ring.at(i);
+}
+
+template <class T, class Policy, class Allocator>
+const T &OverflowCircularBuffer<T, Policy, Allocator>::at(int i) const {
+    return ring.at(i);
+}
+
+// Reference to the first element
+template <class T, class Policy, class Allocator>
+T &OverflowCircularBuffer<T, Policy, Allocator>::front() {
+    return ring.front();
+}
+
+template <class T, class Policy, class Allocator>
+const T &OverflowCircularBuffer<T, Policy, Allocator>::front() const {
+    return ring.front();
+}
+
+// Reference to the last element
+template <class T, class Policy, class Allocator>
+T &OverflowCircularBuffer<T, Policy, Allocator>::back() {
+    return ring.back();
+}
+
+template <class T, class Policy, class Allocator>
+const T &OverflowCircularBuffer<T, Policy, Allocator>::back() const {
+    return ring.back();
+}
+
+// Returns the number of elements stored in the buffer
+template <class T, class Policy, class Allocator>
+int OverflowCircularBuffer<T, Policy, Allocator>::size() const {
+    return ring.size();
+}
+
+// Checks if the buffer is empty
+template <class T, class Policy, class Allocator>
+bool OverflowCircularBuffer<T, Policy, Allocator>::empty() const {
+    return ring.empty();
+}
+
+// Checks if the buffer is full (size == capacity)
+template <class T, class Policy, class Allocator>
+bool OverflowCircularBuffer<T, Policy, Allocator>::full() const {
+    return ring.full();
+}
+
+// Returns the number of free slots in the buffer
+template <class T, class Policy, class Allocator>
+int OverflowCircularBuffer<T, Policy, Allocator>::reserve() const {
+    return ring.reserve();
+}
+
+// Returns the capacity of the buffer
+template <class T, class Policy, class Allocator>
+int OverflowCircularBuffer<T, Policy, Allocator>::capacity() const {
+    return ring.capacity();
+}
+
+// Returns the number of elements evicted or rejected since construction or reset_dropped()
+template <class T, class Policy, class Allocator>
+std::uint64_t OverflowCircularBuffer<T, Policy, Allocator>::dropped() const {
+    return dropped_count;
+}
+
+// Resets the dropped counter to zero
+template <class T, class Policy, class Allocator>
+void OverflowCircularBuffer<T, Policy, Allocator>::reset_dropped() {
+    dropped_count = 0;
+}
+
+// Returns the overflow policy
+template <class T, class Policy, class Allocator>
+Policy &OverflowCircularBuffer<T, Policy, Allocator>::policy() {
+    return overflow;
+}
+
+template <class T, class Policy, class Allocator>
+const Policy &OverflowCircularBuffer<T, Policy, Allocator>::policy() const {
+    return overflow;
+}
+
+// Adds an element to the end of the buffer
+// Returns false if the buffer is full and the policy rejects the element
+template <class T, class Policy, class Allocator>
+bool OverflowCircularBuffer<T, Policy, Allocator>::push_back(const value_type &item) {
+    if (!make_room(true)) {
+        return false;
+    }
+    ring.push_back(item);
+    return true;
+}
+
+template <class T, class Policy, class Allocator>
+bool OverflowCircularBuffer<T, Policy, Allocator>::push_back(value_type &&item) {
+    if (!make_room(true)) {
+        return false;
+    }
+    ring.push_back(std::move(item));
+    return true;
+}
+
+// Adds a new element before the first element of the buffer
+// Returns false if the buffer is full and the policy rejects the element
+template <class T, class Policy, class Allocator>
+bool OverflowCircularBuffer<T, Policy, Allocator>::push_front(const value_type &item) {
+    if (!make_room(false)) {
+        return false;
+    }
+    ring.push_front(item);
+    return true;
+}
+
+template <class T, class Policy, class Allocator>
+bool OverflowCircularBuffer<T, Policy, Allocator>::push_front(value_type &&item) {
+    if (!make_room(false)) {
+        return false;
+    }
+    ring.push_front(std::move(item));
+    return true;
+}
+
+// Constructs an element in place after the last element
+// Returns false if the buffer is full and the policy rejects the element
+template <class T, class Policy, class Allocator>
+template <class... Args>
+bool OverflowCircularBuffer<T, Policy, Allocator>::emplace_back(Args &&...args) {
+    if (!make_room(true)) {
+        return false;
+    }
+    ring.emplace_back(std::forward<Args>(args)...);
+    return true;
+}
+
+// Constructs an element in place before the first element
+// Returns false if the buffer is full and the policy rejects the element
+template <class T, class Policy, class Allocator>
+template <class... Args>
+bool OverflowCircularBuffer<T, Policy, Allocator>::emplace_front(Args &&...args) {
+    if (!make_room(false)) {
+        return false;
+    }
+    ring.emplace_front(std::forward<Args>(args)...);
+    return true;
+}
+
+// Adds n elements to the end of the buffer
+// Returns the number of elements stored: a prefix of data if the policy rejects, otherwise n
+template <class T, class Policy, class Allocator>
+int OverflowCircularBuffer<T, Policy, Allocator>::push_back(const value_type *data, int n) {
+    if (n < 0) {
+        throw std::invalid_argument("n must be non-negative");
+    }
+    if constexpr (Policy::overwrites) {
+        if (n == 0) {
+            return 0;
+        }
+        if (ring.capacity() == 0) {
+            throw std::runtime_error("Buffer capacity is zero");
+        }
+        int lost = ring.size() + n - ring.capacity();
+        if (lost > 0) {
+            // Stored elements go first, then the head of data if it does not fit either
+            int stored = lost < ring.size() ? lost : ring.size();
+            for (int i = 0; i < stored; ++i) {
+                overflow.evict(ring[i]);
+            }
+            for (int i = 0; i < lost - stored; ++i) {
+                value_type item(data[i]);
+                overflow.evict(item);
+            }
+            dropped_count += static_cast<std::uint64_t>(lost);
+        }
+        ring.push_back(data, n);
+        return n;
+    } else {
+        int accepted = n < ring.reserve() ? n : ring.reserve();
+        ring.push_back(data, accepted);
+        dropped_count += static_cast<std::uint64_t>(n - accepted);
+        return accepted;
+    }
+}
+
+// Removes the last element of the buffer
+template <class T, class Policy, class Allocator>
+void OverflowCircularBuffer<T, Policy, Allocator>::pop_back() {
+    ring.pop_back();
+}
+
+// Removes the first element of the buffer
+template <class T, class Policy, class Allocator>
+void OverflowCircularBuffer<T, Policy, Allocator>::pop_front() {
+    ring.pop_front();
+}
+
+// Removes the first n elements of the buffer and copies them into out
+template <class T, class Policy, class Allocator>
+void OverflowCircularBuffer<T, Policy, Allocator>::pop_front(value_type *out, int n) {
+    ring.pop_front(out, n);
+}
+
+// Clears the buffer; the dropped counter is kept
+template <class T, class Policy, class Allocator>
+void OverflowCircularBuffer<T, Policy, Allocator>::clear() {
+    ring.clear();
+}
+
+// Iterators over the elements in logical order
+template <class T, class Policy, class Allocator>
+typename OverflowCircularBuffer<T, Policy, Allocator>::iterator OverflowCircularBuffer<T, Policy, Allocator>::begin() {
+    return ring.begin();
+}
+
+template <class T, class Policy, class Allocator>
+typename OverflowCircularBuffer<T, Policy, Allocator>::iterator OverflowCircularBuffer<T, Policy, Allocator>::end() {
+    return ring.end();
+}
+
+template <class T, class Policy, class Allocator>
+typename OverflowCircularBuffer<T, Policy, Allocator>::const_iterator
+OverflowCircularBuffer<T, Policy, Allocator>::begin() const {
+    return ring.begin();
+}
+
+template <class T, class Policy, class Allocator>
+typename OverflowCircularBuffer<T, Policy, Allocator>::const_iterator
+OverflowCircularBuffer<T, Policy, Allocator>::end() const {
+    return ring.end();
+}
+
+// Returns the underlying buffer
+template <class T, class Policy, class Allocator>
+const CircularBuffer<T, Allocator> &OverflowCircularBuffer<T, Policy, Allocator>::buffer() const {
+    return ring;
+}
@@ -0,0 +1,321 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include "ring-file.h"
+
+// Circular buffer whose storage and header live in a memory-mapped file,
+// so that the contents survive a crash or restart of the process and can
+// be inspected by another process. Pushes are plain stores into the
+// mapping; nothing is written to the disk until checkpoint() or the
+// kernel's own writeback. If the buffer is full, a push overwrites the
+// oldest element. T must be trivially copyable; the file layout depends on
+// sizeof(T), so only code built for the same T and platform may reopen it.
+// A read-only ring observing a live writer must refresh() before reading;
+// elements it copies may be overwritten meanwhile, which a second
+// refresh() detects by an advanced first_sequence().
+template <class T = char>
+class PersistentCircularBuffer {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "PersistentCircularBuffer requires a trivially copyable value_type");
+
+public:
+    typedef T value_type;
+
+    // Contiguous span of the mapped storage
+    struct const_region {
+        const value_type* data;
+        int size;
+    };
+
+private:
+    RingFile file;              // Mapped file
+    RingFileHeader* head;       // Header in the mapping
+    value_type* slots;          // Element slots in the mapping
+    int cap;                    // Capacity of the buffer
+    int start;                  // Index of the first element
+    int count;                  // Number of elements in the buffer
+
+    // Physical index of element i, 0 <= i <= cap
+    int index(int i) const {
+        int j = start + i;
+        return j >= cap ? j - cap : j;
+    }
+
+    // Throws if the ring was opened read-only
+    void check_writable() const;
+
+public:
+    // Opens the ring stored at path, creating it with the given capacity if needed
+    // A capacity of zero takes the capacity from an existing file
+    explicit PersistentCircularBuffer(const std::string& path, int capacity = 0,
+                                      RingFileMode mode = RingFileMode::OpenOrCreate);
+
+    PersistentCircularBuffer(const PersistentCircularBuffer&) = delete;
+    PersistentCircularBuffer& operator=(const PersistentCircularBuffer&) = delete;
+
+    // Access by index without bounds checking
+    const value_type& operator[](int i) const;
+
+    // Access by index with bounds checking
+    const value_type& at(int i) const;
+
+    // Reference to the first element
+    const value_type& front() const;
+
+    // Reference to the last element
+    const value_type& back() const;
+
+    // Returns the number of elements stored in the buffer
+    int size() const;
+
+    // Checks if the buffer is empty
+    bool empty() const;
+
+    // Checks if the buffer is full (size == capacity)
+    bool full() const;
+
+    // Returns the capacity of the buffer
+    int capacity() const;
+
+    // Returns the number of elements removed from the front since the file was created
+    // Element i has sequence number first_sequence() + i
+    std::uint64_t first_sequence() const;
+
+    // Adds an element to the end of the buffer
+    // If the buffer is full, the first element is overwritten
+    void push_back(const value_type& item);
+
+    // Adds n elements to the end of the buffer
+    // Equivalent to calling push_back for data[0], ..., data[n - 1]
+    void push_back(const value_type* data, int n);
+
+    // Removes the first element of the buffer
+    void pop_front();
+
+    // Removes the first n elements of the buffer
+    void consume(int n);
+
+    // Clears the buffer
+    void clear();
+
+    // Returns up to two spans holding the elements, in order
+    std::array<const_region, 2> read_regions() const;
+
+    // Returns up to two spans holding the last n elements, in order
+    std::array<const_region, 2> last_regions(int n) const;
+
+    // Reloads the position of the elements from the file, for read-only rings
+    void refresh();
+
+    // Flushes the contents to the disk; with wait false only schedules the write
+    void checkpoint(bool wait = true);
+};
+
+// Opens the ring stored at path, creating it with the given capacity if needed
+// A capacity of zero takes the capacity from an existing file
+template <class T>
+PersistentCircularBuffer<T>::PersistentCircularBuffer(const std::string &path, int capacity, RingFileMode mode)
+    : head(nullptr), slots(nullptr), cap(0), start(0), count(0) {
+    if (capacity < 0) {
+        throw std::invalid_argument("Capacity must be non-negative");
+    }
+    file = RingFile(path, sizeof(value_type), alignof(value_type), static_cast<std::uint64_t>(capacity), mode);
+    head = file.header();
+    if (head->capacity > static_cast<std::uint64_t>(INT_MAX)) {
+        throw std::runtime_error("Ring file has an incompatible layout");
+    }
+    slots = reinterpret_cast<value_type*>(file.data());
+    cap = static_cast<int>(head->capacity);
+    refresh();
+}
+
+// Throws if the ring was opened read-only
+template <class T>
+void PersistentCircularBuffer<T>::check_writable() const {
+    if (!file.writable()) {
+        throw std::runtime_error("Ring is read-only");
+    }
+}
+
+// Access by index without bounds checking
+template <class T>
+const T &PersistentCircularBuffer<T>::operator[](int i) const {
+    return slots[index(i)];
+}
+
+// Access by index with bounds checking
+template <class T>
+const T &PersistentCircularBuffer<T>::at(int i) const {
+    if (i < 0 || i >= count) {
+        throw std::out_of_range("Index out of range");
+    }
+    return slots[index(i)];
+}
+
+// Reference to the first element
+template <class T>
+const T &PersistentCircularBuffer<T>::front() const {
+    if (empty()) {
+        throw std::runtime_error("Buffer is empty");
+    }
+    return slots[start];
+}
+
+// Reference to the last element
+template <class T>
+const T &PersistentCircularBuffer<T>::back() const {
+    if (empty()) {
+        throw std::runtime_error("Buffer is empty");
+    }
+    return slots[index(count - 1)];
+}
+
+// Returns the number of elements stored in the buffer
+template <class T>
+int PersistentCircularBuffer<T>::size() const {
+    return count;
+}
+
+// Checks if the buffer is empty
+template <class T>
+bool PersistentCircularBuffer<T>::empty() const {
+    return count == 0;
+}
+
+// Checks if the buffer is full (size == capacity)
+template <class T>
+bool PersistentCircularBuffer<T>::full() const {
+    return count == cap;
+}
+
+// Returns the capacity of the buffer
+template <class T>
+int PersistentCircularBuffer<T>::capacity() const {
+    return cap;
+}
+
+// Returns the number of elements removed from the front since the file was created
+// Element i has sequence number first_sequence() + i
+template <class T>
+std::uint64_t PersistentCircularBuffer<T>::first_sequence() const {
+    return head->first.load(std::memory_order_acquire);
+}
+
+// Adds an element to the end of the buffer
+// If the buffer is full, the first element is overwritten
+template <class T>
+void PersistentCircularBuffer<T>::push_back(const value_type &item) {
+    check_writable();
+    int slot = index(count);
+    if (full()) {
+        // Drop the oldest element from the header before its slot is reused
+        head->first.store(head->first.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        start = start + 1 == cap ? 0 : start + 1;
+    } else {
+        ++count;
+    }
+    std::memcpy(static_cast<void*>(slots + slot), &item, sizeof(value_type));
+    head->last.store(head->last.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+// Adds n elements to the end of the buffer
+// Equivalent to calling push_back for data[0], ..., data[n - 1]
+template <class T>
+void PersistentCircularBuffer<T>::push_back(const value_type *data, int n) {
+    if (n < 0) {
+        throw std::invalid_argument("n must be non-negative");
+    }
+    check_writable();
+    // Elements pushed and overwritten within this call still count in the sequence numbers
+    long long overflow = static_cast<long long>(count) + n - cap;
+    int skipped = n > cap ? n - cap : 0;
+    int stored = n - skipped;
+    if (overflow > 0) {
+        std::uint64_t first_seq = head->first.load(std::memory_order_relaxed) + overflow;
+        head->first.store(first_seq, std::memory_order_release);
+        // Element with sequence number s lives in slot s % cap, as refresh() expects
+        start = cap == 0 ? 0 : static_cast<int>(first_seq % static_cast<std::uint64_t>(cap));
+        count = cap - stored;
+    }
+    int slot = index(count);
+    int first = stored < cap - slot ? stored : cap - slot;
+    std::memcpy(static_cast<void*>(slots + slot), data + skipped, first * sizeof(value_type));
+    std::memcpy(static_cast<void*>(slots), data + skipped + first, (stored - first) * sizeof(value_type));
+    count += stored;
+    head->last.store(head->last.load(std::memory_order_relaxed) + n, std::memory_order_release);
+}
+
+// Removes the first element of the buffer
+template <class T>
+void PersistentCircularBuffer<T>::pop_front() {
+    if (empty()) {
+        throw std::runtime_error("Buffer is empty");
+    }
+    consume(1);
+}
+
+// Removes the first n elements of the buffer
+template <class T>
+void PersistentCircularBuffer<T>::consume(int n) {
+    if (n < 0 || n > count) {
+        throw std::out_of_range("n exceeds the number of elements");
+    }
+    check_writable();
+    head->first.store(head->first.load(std::memory_order_relaxed) + n, std::memory_order_release);
+    start = index(n);
+    count -= n;
+}
+
+// Clears the buffer
+template <class T>
+void PersistentCircularBuffer<T>::clear() {
+    consume(count);
+}
+
+// Returns up to two spans holding the elements, in order
+template <class T>
+std::array<typename PersistentCircularBuffer<T>::const_region, 2> PersistentCircularBuffer<T>::read_regions() const {
+    return last_regions(count);
+}
+
+// Returns up to two spans holding the last n elements, in order
+template <class T>
+std::array<typename PersistentCircularBuffer<T>::const_region, 2>
+PersistentCircularBuffer<T>::last_regions(int n) const {
+    if (n < 0 || n > count) {
+        throw std::out_of_range("n exceeds the number of elements");
+    }
+    int j = index(count - n);
+    int first = n < cap - j ? n : cap - j;
+    return {{{slots + j, first}, {slots, n - first}}};
+}
+
+// Reloads the position of the elements from the file, for read-only rings
+template <class T>
+void PersistentCircularBuffer<T>::refresh() {
+    std::uint64_t last = head->last.load(std::memory_order_acquire);
+    std::uint64_t first = head->first.load(std::memory_order_acquire);
+    // A writer may have moved on between the two loads
+    if (first > last) {
+        first = last;
+    }
+    if (last - first > static_cast<std::uint64_t>(cap)) {
+        first = last - cap;
+    }
+    start = cap == 0 ? 0 : static_cast<int>(first % static_cast<std::uint64_t>(cap));
+    count = static_cast<int>(last - first);
+}
+
+// Flushes the contents to the disk; with wait false only schedules the write
+template <class T>
+void PersistentCircularBuffer<T>::checkpoint(bool wait) {
+    file.sync(wait);
+}
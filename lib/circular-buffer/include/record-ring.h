@@ -0,0 +1,118 @@
+#pragma once
+
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "circular-buffer.h"
+
+// Read-only view of one record stored in a RecordRing
+struct RecordView {
+    const char* data;    // First byte of the payload, contiguous
+    std::size_t size;    // Length of the payload in bytes
+};
+
+// Queue of variable-length byte records stored in a CircularBuffer<char>.
+// Each record is a 4-byte length header followed by the payload, padded to
+// a multiple of 4 bytes. A record never wraps around the end of the
+// storage: if it does not fit before the end, a skip marker fills the
+// rest and the record starts over at the beginning. Payloads are therefore
+// always contiguous and can be read in place.
+class RecordRing {
+public:
+    // Alignment of headers and payloads within the storage
+    static constexpr int alignment = 4;
+
+private:
+    typedef std::uint32_t header_type;
+
+    // Header value that marks the rest of the storage as padding
+    static constexpr header_type skip_marker = 0xFFFFFFFFu;
+
+    CircularBuffer<char> ring;   // Framed bytes
+    int records;                 // Number of records in the ring
+
+    // Bytes taken by a record with a payload of size bytes
+    static std::size_t framed_size(std::size_t size) {
+        return sizeof(header_type) + (size + alignment - 1) / alignment * alignment;
+    }
+
+    // Reads the header stored at p
+    static header_type read_header(const char* p) {
+        header_type h;
+        std::memcpy(&h, p, sizeof(h));
+        return h;
+    }
+
+    // Returns the header of the first record and the bytes of padding before it
+    const char* first_record(int& skipped) const;
+
+public:
+    // Constructs a ring of the given size in bytes, rounded up to a multiple of alignment
+    explicit RecordRing(int capacity);
+
+    // Appends a copy of data[0, size) as one record
+    // Returns false if the ring has no room for it right now
+    bool push_record(const void* data, std::size_t size);
+
+    // Returns the first record without removing it
+    RecordView peek_record() const;
+
+    // Removes the first record
+    void pop_record();
+
+    // Calls f(RecordView) for up to max_records records from the front, in order,
+    // then removes them all at once
+    // Returns the number of records removed
+    template <class F>
+    int drain(F f, int max_records = INT_MAX);
+
+    // Returns the number of records in the ring
+    int size() const;
+
+    // Checks if the ring holds no records
+    bool empty() const;
+
+    // Returns the number of bytes in use, including headers and padding
+    int bytes_used() const;
+
+    // Returns the capacity of the ring in bytes
+    int capacity() const;
+
+    // Returns the largest payload the ring can ever hold
+    std::size_t max_record_size() const;
+
+    // Removes all records
+    void clear();
+};
+
+// Calls f(RecordView) for up to max_records records from the front, in order,
+// then removes them all at once
+// Returns the number of records removed
+template <class F>
+int RecordRing::drain(F f, int max_records) {
+    int done = 0;
+    int consumed = 0;
+    auto spans = ring.read_regions();
+    // Records are walked in place: first to the end of the first span, then in the second one
+    for (int s = 0; s < 2 && done < max_records; ++s) {
+        const char* p = spans[s].data;
+        const char* end = p + spans[s].size;
+        while (p != end && done < max_records) {
+            header_type h = read_header(p);
+            if (h == skip_marker) {
+                consumed += static_cast<int>(end - p);
+                break;
+            }
+            f(RecordView{p + sizeof(header_type), h});
+            int framed = static_cast<int>(framed_size(h));
+            p += framed;
+            consumed += framed;
+            ++done;
+        }
+    }
+    ring.consume(consumed);
+    records -= done;
+    return done;
+}
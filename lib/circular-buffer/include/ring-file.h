@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Version of the ring file layout written by this code
+const std::uint32_t ring_file_version = 1;
+
+// Header at the start of a ring file. The elements follow at data_offset.
+// Element i of the ring, counting from the oldest one, lives in slot
+// (first + i) % capacity; first and last only ever grow, so a header torn by a
+// crash between their updates still describes a valid, possibly shorter ring.
+struct RingFileHeader {
+    char magic[8];                      // "CBRING" padded with zeros
+    std::uint32_t version;              // Layout version, ring_file_version
+    std::uint32_t element_size;         // Size of one element in bytes
+    std::uint64_t capacity;             // Number of element slots
+    std::uint64_t data_offset;          // Offset of slot 0 from the start of the file
+    std::atomic<std::uint64_t> first;   // Number of elements removed from the front so far
+    std::atomic<std::uint64_t> last;    // Number of elements added at the back so far
+};
+
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+              "Ring file counters must be lock-free to be shared through a file");
+
+// How a RingFile opens its file
+enum class RingFileMode {
+    OpenOrCreate,   // Open an existing ring with the same layout, or create a new one
+    OpenExisting,   // Open an existing ring; fail if there is none
+    ReadOnly        // Open an existing ring for inspection only
+};
+
+// A ring file mapped into memory with MAP_SHARED: stores into data() and
+// the header reach the page cache directly and survive a crash of the
+// process; sync() additionally flushes them to the disk.
+// Linux only; elsewhere the constructor throws.
+class RingFile {
+private:
+    unsigned char* base;   // Start of the mapping
+    std::size_t length;    // Length of the mapping in bytes
+    bool can_write;        // The mapping is writable
+
+public:
+    // Creates an empty mapping
+    RingFile();
+
+    // Opens the ring at path holding capacity elements of element_size bytes
+    // A capacity of zero takes the capacity from an existing file
+    RingFile(const std::string& path, std::size_t element_size, std::size_t element_align,
+             std::uint64_t capacity, RingFileMode mode);
+
+    // Destructor
+    ~RingFile();
+
+    RingFile(const RingFile&) = delete;
+    RingFile& operator=(const RingFile&) = delete;
+
+    // Move constructor and assignment
+    RingFile(RingFile&& other) noexcept;
+    RingFile& operator=(RingFile&& other) noexcept;
+
+    // Header at the start of the mapping
+    RingFileHeader* header() const;
+
+    // Start of the element slots
+    unsigned char* data() const;
+
+    // Checks if the ring may be modified
+    bool writable() const;
+
+    // Flushes the mapping to the file, waiting for the write if wait is true
+    void sync(bool wait);
+
+    // Swaps two mappings
+    void swap(RingFile& other) noexcept;
+};
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "circular-buffer.h"
+
+// Layout of the shared memory segment behind SharedSpscCircularBuffer.
+// The segment holds no pointers: slot 0 lives data_offset bytes after the
+// header, so every process may map it at a different address.
+struct SharedRingHeader {
+    static const std::size_t cache_line = 64;
+
+    char magic[8];                       // "CBSHM" padded with zeros
+    std::uint32_t version;               // Layout version
+    std::uint32_t element_size;          // Size of one element in bytes
+    std::uint64_t capacity;              // Number of element slots
+    std::uint64_t data_offset;           // Offset of slot 0 from the header
+    std::atomic<std::uint32_t> ready;    // Set by the creator once the header is filled in
+
+    // Consumer side: index of the next element to read
+    alignas(cache_line) std::atomic<std::uint64_t> head;
+
+    // Producer side: index of the next free slot
+    alignas(cache_line) std::atomic<std::uint64_t> tail;
+};
+
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+              "Shared ring indices must be lock-free to be shared between processes");
+
+// Lock-free ring for one producer process and one consumer process,
+// stored in a POSIX shared memory segment (shm_open + mmap). Like
+// SpscCircularBuffer, head and tail are free-running counters on separate
+// cache lines; each side keeps its cached copy of the other's counter in
+// its own process. A full ring rejects new elements.
+// The creator owns the name and unlinks it on destruction; processes that
+// have already attached keep their mapping. Linux only; elsewhere the
+// constructors throw.
+class SharedSpscCircularBuffer {
+public:
+    typedef char value_type;
+
+private:
+    SharedRingHeader* header;   // Start of the mapping
+    value_type* slots;          // Element slots in the mapping
+    std::size_t length;         // Length of the mapping in bytes
+    std::size_t cap;            // Capacity of the ring
+    std::string segment;        // Name of the segment
+    bool owner;                 // The segment was created by this object
+    std::uint64_t cached_head;  // Producer's last observed value of head
+    std::uint64_t cached_tail;  // Consumer's last observed value of tail
+
+    // Maps length bytes of the open segment fd
+    void map(int fd, bool create);
+
+public:
+    // Creates a segment with the given name and capacity, replacing a stale one
+    // The name must start with a slash, as required by shm_open
+    SharedSpscCircularBuffer(const std::string& name, int capacity);
+
+    // Attaches to a segment created by another process
+    explicit SharedSpscCircularBuffer(const std::string& name);
+
+    // Destructor
+    ~SharedSpscCircularBuffer();
+
+    SharedSpscCircularBuffer(const SharedSpscCircularBuffer&) = delete;
+    SharedSpscCircularBuffer& operator=(const SharedSpscCircularBuffer&) = delete;
+
+    // Producer: adds an element to the end of the ring
+    // Returns false if the ring is full
+    bool try_push(const value_type& item);
+
+    // Producer: adds up to n elements from data to the end of the ring
+    // Returns the number of elements added; the consumer sees them all at once
+    int try_push(const value_type* data, int n);
+
+    // Consumer: removes the first element of the ring into item
+    // Returns false if the ring is empty
+    bool try_pop(value_type& item);
+
+    // Consumer: removes up to n elements from the front of the ring into out
+    // Returns the number of elements removed
+    int try_pop(value_type* out, int n);
+
+    // Consumer: calls f on up to n elements from the front, then removes them with a single store of head
+    // f takes either a contiguous run (const value_type* first, const value_type* last) or one element
+    // Returns the number of elements removed
+    template <class F>
+    int consume_up_to(int n, F f);
+
+    // Consumer: calls f on every element present at the time of the call, then removes them; see consume_up_to
+    template <class F>
+    int consume_all(F f);
+
+    // Returns the number of stored elements; exact only when both sides are idle
+    int size() const;
+
+    // Checks if the ring is empty
+    bool empty() const;
+
+    // Returns the capacity of the ring
+    int capacity() const;
+
+    // Returns the name of the segment
+    const std::string& name() const;
+
+    // Removes a segment name left behind by a crashed creator
+    static void unlink(const std::string& name);
+};
+
+// Consumer: calls f on up to n elements from the front, then removes them with a single store of head
+// f takes either a contiguous run (const value_type* first, const value_type* last) or one element
+// Returns the number of elements removed
+template <class F>
+int SharedSpscCircularBuffer::consume_up_to(int n, F f) {
+    if (n < 0) {
+        throw std::invalid_argument("n must be non-negative");
+    }
+    std::uint64_t h = header->head.load(std::memory_order_relaxed);
+    std::size_t wanted = static_cast<std::size_t>(n);
+    if (static_cast<std::size_t>(cached_tail - h) < wanted) {
+        cached_tail = header->tail.load(std::memory_order_acquire);
+    }
+    std::size_t k = std::min(static_cast<std::size_t>(cached_tail - h), wanted);
+    if (k == 0) {
+        return 0;
+    }
+    std::size_t slot = static_cast<std::size_t>(h % cap);
+    std::size_t first = std::min(k, cap - slot);
+    detail::consume_run(static_cast<const value_type*>(slots + slot), first, f);
+    detail::consume_run(static_cast<const value_type*>(slots), k - first, f);
+    header->head.store(h + k, std::memory_order_release);
+    return static_cast<int>(k);
+}
+
+// Consumer: calls f on every element present at the time of the call, then removes them; see consume_up_to
+template <class F>
+int SharedSpscCircularBuffer::consume_all(F f) {
+    return consume_up_to(static_cast<int>(cap), std::move(f));
+}
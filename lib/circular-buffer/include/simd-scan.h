@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+
+// Byte scanning kernels behind CircularBuffer::find and count for byte
+// element types. Each comes in a scalar, an SSE2 and an AVX2 version; the
+// best one the CPU supports is picked on first use.
+
+// Instruction set used by the kernels
+enum class ScanLevel {
+    Scalar,   // Plain loops and the C library
+    Sse2,     // 16 bytes per step
+    Avx2      // 32 bytes per step
+};
+
+// Returns the instruction set the kernels currently use
+ScanLevel scan_level();
+
+// Makes the kernels use at most the given instruction set, for tests and benchmarks
+// Returns the instruction set actually in effect, which the CPU may cap
+ScanLevel set_scan_level(ScanLevel level);
+
+// Returns the first byte equal to value in [first, last), or last
+const char* scan_find(const char* first, const char* last, char value);
+
+// Returns the number of bytes equal to value in [first, last)
+std::size_t scan_count(const char* first, const char* last, char value);
+
+// Returns the start of the first occurrence of needle[0, n) lying entirely in [first, last),
+// or last; an empty needle matches at first
+const char* scan_search(const char* first, const char* last, const char* needle, std::size_t n);
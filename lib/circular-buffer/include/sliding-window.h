@@ -0,0 +1,279 @@
+#pragma once
+
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+
+#include "circular-buffer.h"
+
+// Fixed-size window over the most recent values that keeps their sum, mean,
+// variance, min and max up to date as values enter and leave.
+// A push into a full window evicts the oldest value, like CircularBuffer.
+// Every update costs O(1) amortized: sum, mean and variance are adjusted
+// with running formulas (Welford's for the variance), and min and max are
+// the fronts of two monotonic queues of candidates. For floating-point
+// values the running sums collect rounding error over many updates;
+// recompute() rebuilds them from the stored values.
+template <class T = double>
+class SlidingWindow {
+    static_assert(std::is_arithmetic<T>::value, "SlidingWindow requires an arithmetic value_type");
+
+public:
+    typedef T value_type;
+    // Exact for integral values, double otherwise
+    typedef typename std::conditional<std::is_integral<T>::value, long long, double>::type sum_type;
+
+private:
+    // Candidate for the minimum or maximum and the sequence number of its value
+    struct Candidate {
+        std::uint64_t seq;
+        value_type value;
+    };
+
+    CircularBuffer<value_type> values;   // Values in the window, oldest first
+    CircularBuffer<Candidate> lows;      // Increasing candidates for the minimum
+    CircularBuffer<Candidate> highs;     // Decreasing candidates for the maximum
+    std::uint64_t first_seq;             // Sequence number of values.front()
+    sum_type total;                      // Sum of the values
+    double running_mean;                 // Mean of the values
+    double m2;                           // Sum of squared deviations from the mean
+
+    // Removes the oldest value from the aggregates and the window
+    void evict();
+
+    // Throws if the window is empty
+    void check_not_empty() const;
+
+public:
+    // Constructs an empty window holding at most capacity values
+    explicit SlidingWindow(int capacity);
+
+    // Adds a value, evicting the oldest one if the window is full
+    void push_back(value_type value);
+
+    // Removes the oldest value
+    void pop_front();
+
+    // Removes all values
+    void clear();
+
+    // Access by index without bounds checking, 0 is the oldest value
+    const value_type& operator[](int i) const;
+
+    // Oldest and newest values
+    const value_type& front() const;
+    const value_type& back() const;
+
+    // Returns the number of values in the window
+    int size() const;
+
+    // Checks if the window is empty
+    bool empty() const;
+
+    // Checks if the window is full (size == capacity)
+    bool full() const;
+
+    // Returns the capacity of the window
+    int capacity() const;
+
+    // Sum of the values, zero for an empty window
+    sum_type sum() const;
+
+    // Mean of the values
+    double mean() const;
+
+    // Population variance of the values
+    double variance() const;
+
+    // Sample variance of the values, zero for fewer than two values
+    double sample_variance() const;
+
+    // Smallest and largest values
+    value_type min() const;
+    value_type max() const;
+
+    // Rebuilds sum, mean and variance from the stored values in O(n)
+    void recompute();
+};
+
+// Constructs an empty window holding at most capacity values
+template <class T>
+SlidingWindow<T>::SlidingWindow(int capacity)
+    : values(capacity), lows(capacity), highs(capacity), first_seq(0), total(0), running_mean(0), m2(0) {}
+
+// Removes the oldest value from the aggregates and the window
+template <class T>
+void SlidingWindow<T>::evict() {
+    value_type x = values.front();
+    values.pop_front();
+    if (!lows.empty() && lows.front().seq == first_seq) {
+        lows.pop_front();
+    }
+    if (!highs.empty() && highs.front().seq == first_seq) {
+        highs.pop_front();
+    }
+    ++first_seq;
+    total -= static_cast<sum_type>(x);
+    int n = values.size();
+    if (n == 0) {
+        running_mean = 0;
+        m2 = 0;
+        return;
+    }
+    double d = static_cast<double>(x) - running_mean;
+    running_mean -= d / n;
+    m2 -= d * (static_cast<double>(x) - running_mean);
+}
+
+// Throws if the window is empty
+template <class T>
+void SlidingWindow<T>::check_not_empty() const {
+    if (values.empty()) {
+        throw std::runtime_error("Buffer is empty");
+    }
+}
+
+// Adds a value, evicting the oldest one if the window is full
+template <class T>
+void SlidingWindow<T>::push_back(value_type value) {
+    if (values.capacity() == 0) {
+        throw std::runtime_error("Buffer capacity is zero");
+    }
+    if (values.full()) {
+        evict();
+    }
+    std::uint64_t seq = first_seq + static_cast<std::uint64_t>(values.size());
+    values.push_back(value);
+    // Candidates dominated by the new value can never become the min or max
+    while (!lows.empty() && !(lows.back().value < value)) {
+        lows.pop_back();
+    }
+    lows.push_back(Candidate{seq, value});
+    while (!highs.empty() && !(value < highs.back().value)) {
+        highs.pop_back();
+    }
+    highs.push_back(Candidate{seq, value});
+
+    total += static_cast<sum_type>(value);
+    double d = static_cast<double>(value) - running_mean;
+    running_mean += d / values.size();
+    m2 += d * (static_cast<double>(value) - running_mean);
+}
+
+// Removes the oldest value
+template <class T>
+void SlidingWindow<T>::pop_front() {
+    check_not_empty();
+    evict();
+}
+
+// Removes all values
+template <class T>
+void SlidingWindow<T>::clear() {
+    first_seq += static_cast<std::uint64_t>(values.size());
+    values.clear();
+    lows.clear();
+    highs.clear();
+    total = 0;
+    running_mean = 0;
+    m2 = 0;
+}
+
+// Access by index without bounds checking, 0 is the oldest value
+template <class T>
+const T &SlidingWindow<T>::operator[](int i) const {
+    return values[i];
+}
+
+// Oldest and newest values
+template <class T>
+const T &SlidingWindow<T>::front() const {
+    return values.front();
+}
+
+template <class T>
+const T &SlidingWindow<T>::back() const {
+    return values.back();
+}
+
+// Returns the number of values in the window
+template <class T>
+int SlidingWindow<T>::size() const {
+    return values.size();
+}
+
+// Checks if the window is empty
+template <class T>
+bool SlidingWindow<T>::empty() const {
+    return values.empty();
+}
+
+// Checks if the window is full (size == capacity)
+template <class T>
+bool SlidingWindow<T>::full() const {
+    return values.full();
+}
+
+// Returns the capacity of the window
+template <class T>
+int SlidingWindow<T>::capacity() const {
+    return values.capacity();
+}
+
+// Sum of the values, zero for an empty window
+template <class T>
+typename SlidingWindow<T>::sum_type SlidingWindow<T>::sum() const {
+    return total;
+}
+
+// Mean of the values
+template <class T>
+double SlidingWindow<T>::mean() const {
+    check_not_empty();
+    return running_mean;
+}
+
+// Population variance of the values
+template <class T>
+double SlidingWindow<T>::variance() const {
+    check_not_empty();
+    // Rounding may push a zero variance slightly below zero
+    return m2 > 0 ? m2 / values.size() : 0.0;
+}
+
+// Sample variance of the values, zero for fewer than two values
+template <class T>
+double SlidingWindow<T>::sample_variance() const {
+    check_not_empty();
+    return values.size() > 1 && m2 > 0 ? m2 / (values.size() - 1) : 0.0;
+}
+
+// Smallest and largest values
+template <class T>
+T SlidingWindow<T>::min() const {
+    check_not_empty();
+    return lows.front().value;
+}
+
+template <class T>
+T SlidingWindow<T>::max() const {
+    check_not_empty();
+    return highs.front().value;
+}
+
+// Rebuilds sum, mean and variance from the stored values in O(n)
+template <class T>
+void SlidingWindow<T>::recompute() {
+    total = 0;
+    running_mean = 0;
+    m2 = 0;
+    int n = 0;
+    for (int i = 0; i < values.size(); ++i) {
+        double x = static_cast<double>(values[i]);
+        total += static_cast<sum_type>(values[i]);
+        ++n;
+        double d = x - running_mean;
+        running_mean += d / n;
+        m2 += d * (x - running_mean);
+    }
+}
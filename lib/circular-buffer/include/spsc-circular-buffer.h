@@ -0,0 +1,123 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+#include "circular-buffer.h"
+
+// What a producer does when it finds the ring full
+enum class OverflowMode {
+    Reject,     // try_push fails and the new element is dropped
+    Overwrite   // the oldest element is dropped to make room
+};
+
+// Lock-free ring for exactly one producer thread and one consumer thread.
+// head and tail are free-running counters kept on separate cache lines;
+// slots are addressed as counter % capacity.
+// In Overwrite mode the consumer may copy a slot that the producer is
+// recycling; such copies are detected and discarded. The slots are atomics
+// in that mode, so the racing copy is a relaxed load rather than a data race.
+class SpscCircularBuffer {
+public:
+    typedef char value_type;
+
+private:
+    static const std::size_t cache_line = 64;
+
+    value_type* buffer;                // Pointer to the buffer array in Reject mode
+    std::atomic<value_type>* slots;    // Slots in Overwrite mode, read while the producer recycles them
+    std::size_t cap;       // Capacity of the buffer
+    OverflowMode mode;     // Behaviour of try_push on a full ring
+
+    // Consumer side: index of the next element to read
+    alignas(cache_line) std::atomic<std::size_t> head;
+    std::size_t cached_tail;   // Consumer's last observed value of tail
+
+    // Producer side: index of the next free slot
+    alignas(cache_line) std::atomic<std::size_t> tail;
+    std::size_t cached_head;   // Producer's last observed value of head
+
+    bool try_pop_overwrite(value_type& item);
+
+public:
+    // Constructs a ring with a given capacity and overflow behaviour
+    explicit SpscCircularBuffer(int capacity, OverflowMode mode = OverflowMode::Reject);
+
+    // Destructor
+    ~SpscCircularBuffer();
+
+    SpscCircularBuffer(const SpscCircularBuffer&) = delete;
+    SpscCircularBuffer& operator=(const SpscCircularBuffer&) = delete;
+
+    // Producer: adds an element to the end of the ring
+    // Returns false if the ring is full in Reject mode or has zero capacity
+    bool try_push(const value_type& item);
+
+    // Consumer: removes the first element of the ring into item
+    // Returns false if the ring is empty
+    bool try_pop(value_type& item);
+
+    // Consumer: calls f on up to n elements from the front, then removes them with a single store of head
+    // f takes either a contiguous run (const value_type* first, const value_type* last) or one element
+    // In Overwrite mode the elements are popped and passed to f one at a time
+    // Returns the number of elements removed
+    template <class F>
+    int consume_up_to(int n, F f);
+
+    // Consumer: calls f on every element present at the time of the call, then removes them; see consume_up_to
+    template <class F>
+    int consume_all(F f);
+
+    // Returns the number of stored elements; exact only when both sides are idle
+    int size() const;
+
+    // Checks if the ring is empty
+    bool empty() const;
+
+    // Returns the capacity of the ring
+    int capacity() const;
+
+    // Returns the overflow behaviour selected at construction
+    OverflowMode overflow_mode() const;
+};
+
+// Consumer: calls f on up to n elements from the front, then removes them with a single store of head
+// f takes either a contiguous run (const value_type* first, const value_type* last) or one element
+// In Overwrite mode the elements are popped and passed to f one at a time
+// Returns the number of elements removed
+template <class F>
+int SpscCircularBuffer::consume_up_to(int n, F f) {
+    if (n < 0) {
+        throw std::invalid_argument("n must be non-negative");
+    }
+    if (mode == OverflowMode::Overwrite) {
+        // The producer may recycle any slot, so each element is claimed before f sees it
+        int k = 0;
+        value_type item;
+        for (; k < n && try_pop_overwrite(item); ++k) {
+            detail::consume_run(static_cast<const value_type*>(&item), 1, f);
+        }
+        return k;
+    }
+    std::size_t h = head.load(std::memory_order_relaxed);
+    std::size_t wanted = static_cast<std::size_t>(n);
+    if (cached_tail - h < wanted) {
+        cached_tail = tail.load(std::memory_order_acquire);
+    }
+    std::size_t k = std::min(cached_tail - h, wanted);
+    if (k == 0) {
+        return 0;
+    }
+    std::size_t slot = h % cap;
+    std::size_t first = std::min(k, cap - slot);
+    detail::consume_run(static_cast<const value_type*>(buffer + slot), first, f);
+    detail::consume_run(static_cast<const value_type*>(buffer), k - first, f);
+    head.store(h + k, std::memory_order_release);
+    return static_cast<int>(k);
+}
+
+// Consumer: calls f on every element present at the time of the call, then removes them; see consume_up_to
+template <class F>
+int SpscCircularBuffer::consume_all(F f) {
+    return consume_up_to(static_cast<int>(cap), std::move(f));
+}
@@ -0,0 +1,579 @@
+#pragma once
+
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "circular-buffer.h"
+
+// Circular buffer with a capacity fixed at compile time and the storage
+// inline in the object, so a small ring costs no heap allocation and no
+// pointer indirection. The index arithmetic uses the constant N, so the
+// modulo folds into a mask when N is a power of two. Shares the element
+// interface of CircularBuffer; like it, only live elements are constructed.
+template <class T, int N>
+class StaticCircularBuffer {
+    static_assert(N > 0, "StaticCircularBuffer needs a positive capacity");
+
+public:
+    typedef T value_type;
+    typedef value_type& reference;
+    typedef const value_type& const_reference;
+    typedef value_type* pointer;
+    typedef const value_type* const_pointer;
+    typedef CircularBufferIterator<T, false> iterator;
+    typedef CircularBufferIterator<T, true> const_iterator;
+    typedef std::reverse_iterator<iterator> reverse_iterator;
+    typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+private:
+    alignas(T) unsigned char storage[N * sizeof(T)];   // Raw storage, only live elements are constructed
+    int start;                                        // Index of the first element
+    int count;                                        // Number of elements in the buffer
+
+    // Helper function to calculate the actual index in the storage
+    static constexpr int wrap(int i) {
+        return static_cast<int>(static_cast<unsigned>(i) % static_cast<unsigned>(N));
+    }
+
+    // Helper function to calculate the actual index of element i
+    int index(int i) const {
+        return wrap(start + i);
+    }
+
+    // Pointer to the first slot of the storage
+    pointer slots();
+    const_pointer slots() const;
+
+    // Stores item after the last element, overwriting the first element if full
+    template <class U>
+    void store_back(U&& item);
+
+    // Stores item before the first element, overwriting the last element if full
+    template <class U>
+    void store_front(U&& item);
+
+public:
+    // Default constructor
+    StaticCircularBuffer();
+
+    // Constructs a full buffer filled with elem
+    explicit StaticCircularBuffer(const value_type& elem);
+
+    // Destructor
+    ~StaticCircularBuffer();
+
+    // Copy constructor
+    StaticCircularBuffer(const StaticCircularBuffer& cb);
+
+    // Move constructor, moves the elements one by one
+    StaticCircularBuffer(StaticCircularBuffer&& cb) noexcept(std::is_nothrow_move_constructible<T>::value);
+
+    // Assignment operators
+    StaticCircularBuffer& operator=(const StaticCircularBuffer& cb);
+    StaticCircularBuffer& operator=(StaticCircularBuffer&& cb) noexcept(std::is_nothrow_move_constructible<T>::value);
+
+    // Access by index without bounds checking
+    value_type& operator[](int i);
+    const value_type& operator[](int i) const;
+
+    // Access by index with bounds checking
+    value_type& at(int i);
+    const value_type& at(int i) const;
+
+    // Reference to the first element
+    value_type& front();
+    const value_type& front() const;
+
+    // Reference to the last element
+    value_type& back();
+    const value_type& back() const;
+
+    // Linearizes the buffer so that the first element is at the beginning of the storage
+    value_type* linearize();
+
+    // Checks if the buffer is linearized
+    bool is_linearized() const;
+
+    // Returns the number of elements stored in the buffer
+    int size() const;
+
+    // Checks if the buffer is empty
+    bool empty() const;
+
+    // Checks if the buffer is full (size == capacity)
+    bool full() const;
+
+    // Returns the number of free slots in the buffer
+    int reserve() const;
+
+    // Returns the capacity of the buffer
+    static constexpr int capacity() {
+        return N;
+    }
+
+    // Swaps the contents of the buffer with another buffer
+    void swap(StaticCircularBuffer& cb);
+
+    // Adds an element to the end of the buffer
+    // If the buffer is full, the first element is overwritten
+    void push_back(const value_type& item = value_type());
+    void push_back(value_type&& item);
+
+    // Adds a new element before the first element of the buffer
+    // If the buffer is full, the last element is overwritten
+    void push_front(const value_type& item = value_type());
+    void push_front(value_type&& item);
+
+    // Constructs an element in place after the last element
+    // If the buffer is full, the first element is overwritten by a temporary built from args
+    template <class... Args>
+    value_type& emplace_back(Args&&... args);
+
+    // Constructs an element in place before the first element
+    // If the buffer is full, the last element is overwritten by a temporary built from args
+    template <class... Args>
+    value_type& emplace_front(Args&&... args);
+
+    // Removes the last element of the buffer
+    void pop_back();
+
+    // Removes the first element of the buffer
+    void pop_front();
+
+    // Inserts an element at the specified position
+    // The capacity of the buffer remains unchanged
+    void insert(int pos, const value_type& item = value_type());
+    void insert(int pos, value_type&& item);
+
+    // Erases elements in the range [first, last)
+    void erase(int first, int last);
+
+    // Clears the buffer
+    void clear();
+
+    // Iterators over the elements in logical order
+    iterator begin();
+    iterator end();
+    const_iterator begin() const;
+    const_iterator end() const;
+    const_iterator cbegin() const;
+    const_iterator cend() const;
+    reverse_iterator rbegin();
+    reverse_iterator rend();
+    const_reverse_iterator rbegin() const;
+    const_reverse_iterator rend() const;
+};
+
+// Equality operators
+template <class T, int N>
+bool operator==(const StaticCircularBuffer<T, N>& a, const StaticCircularBuffer<T, N>& b);
+template <class T, int N>
+bool operator!=(const StaticCircularBuffer<T, N>& a, const StaticCircularBuffer<T, N>& b);
+
+// Pointer to the first slot of the storage
+template <class T, int N>
+T *StaticCircularBuffer<T, N>::slots() {
+    return std::launder(reinterpret_cast<T*>(storage));
+}
+
+template <class T, int N>
+const T *StaticCircularBuffer<T, N>::slots() const {
+    return std::launder(reinterpret_cast<const T*>(storage));
+}
+
+// Stores item after the last element, overwriting the first element if full
+template <class T, int N>
+template <class U>
+void StaticCircularBuffer<T, N>::store_back(U &&item) {
+    if (full()) {
+        slots()[start] = std::forward<U>(item);
+        start = wrap(start + 1);
+    } else {
+        ::new (static_cast<void*>(slots() + index(count))) T(std::forward<U>(item));
+        ++count;
+    }
+}
+
+// Stores item before the first element, overwriting the last element if full
+template <class T, int N>
+template <class U>
+void StaticCircularBuffer<T, N>::store_front(U &&item) {
+    int new_start = wrap(start + N - 1);
+    if (full()) {
+        slots()[new_start] = std::forward<U>(item);
+    } else {
+        ::new (static_cast<void*>(slots() + new_start)) T(std::forward<U>(item));
+        ++count;
+    }
+    start = new_start;
+}
+
+// Default constructor
+template <class T, int N>
+StaticCircularBuffer<T, N>::StaticCircularBuffer() : start(0), count(0) {}
+
+// Constructs a full buffer filled with elem
+template <class T, int N>
+StaticCircularBuffer<T, N>::StaticCircularBuffer(const value_type &elem) : StaticCircularBuffer() {
+    // Delegating makes the destructor clean up if a copy throws
+    for (; count < N; ++count) {
+        ::new (static_cast<void*>(slots() + count)) T(elem);
+    }
+}
+
+// Destructor
+template <class T, int N>
+StaticCircularBuffer<T, N>::~StaticCircularBuffer() {
+    clear();
+}
+
+// Copy constructor
+template <class T, int N>
+StaticCircularBuffer<T, N>::StaticCircularBuffer(const StaticCircularBuffer &cb) : StaticCircularBuffer() {
+    for (; count < cb.count; ++count) {
+        ::new (static_cast<void*>(slots() + count)) T(cb[count]);
+    }
+}
+
+// Move constructor, moves the elements one by one
+template <class T, int N>
+StaticCircularBuffer<T, N>::StaticCircularBuffer(StaticCircularBuffer &&cb) noexcept(
+    std::is_nothrow_move_constructible<T>::value)
+    : StaticCircularBuffer() {
+    for (; count < cb.count; ++count) {
+        ::new (static_cast<void*>(slots() + count)) T(std::move(cb[count]));
+    }
+    cb.clear();
+}
+
+// Assignment operators
+template <class T, int N>
+StaticCircularBuffer<T, N> &StaticCircularBuffer<T, N>::operator=(const StaticCircularBuffer &cb) {
+    if (this != &cb) {
+        StaticCircularBuffer copy(cb);
+        clear();
+        for (; count < copy.count; ++count) {
+            ::new (static_cast<void*>(slots() + count)) T(std::move_if_noexcept(copy[count]));
+        }
+    }
+    return *this;
+}
+
+template <class T, int N>
+StaticCircularBuffer<T, N> &StaticCircularBuffer<T, N>::operator=(StaticCircularBuffer &&cb) noexcept(
+    std::is_nothrow_move_constructible<T>::value) {
+    if (this != &cb) {
+        clear();
+        for (; count < cb.count; ++count) {
+            ::new (static_cast<void*>(slots() + count)) T(std::move(cb[count]));
+        }
+        cb.clear();
+    }
+    return *this;
+}
+
+// Access by index without bounds checking
+template <class T, int N>
+T &StaticCircularBuffer<T, N>::operator[](int i) {
+    return slots()[index(i)];
+}
+
+template <class T, int N>
+const T &StaticCircularBuffer<T, N>::operator[](int i) const {
+    return slots()[index(i)];
+}
+
+// Access by index with bounds checking
+template <class T, int N>
+T &StaticCircularBuffer<T, N>::at(int i) {
+    if (i < 0 || i >= count) {
+        throw std::out_of_range("Index out of range");
+    }
+    return slots()[index(i)];
+}
+
+template <class T, int N>
+const T &StaticCircularBuffer<T, N>::at(int i) const {
+    if (i < 0 || i >= count) {
+        throw std::out_of_range("Index out of range");
+    }
+    return slots()[index(i)];
+}
+
+// Reference to the first element
+template <class T, int N>
+T &StaticCircularBuffer<T, N>::front() {
+    if (empty()) {
+        throw std::runtime_error("Buffer is empty");
+    }
+    return slots()[start];
+}
+
+template <class T, int N>
+const T &StaticCircularBuffer<T, N>::front() const {
+    if (empty()) {
+        throw std::runtime_error("Buffer is empty");
+    }
+    return slots()[start];
+}
+
+// Reference to the last element
+template <class T, int N>
+T &StaticCircularBuffer<T, N>::back() {
+    if (empty()) {
+        throw std::runtime_error("Buffer is empty");
+    }
+    return slots()[index(count - 1)];
+}
+
+template <class T, int N>
+const T &StaticCircularBuffer<T, N>::back() const {
+    if (empty()) {
+        throw std::runtime_error("Buffer is empty");
+    }
+    return slots()[index(count - 1)];
+}
+
+// Linearizes the buffer so that the first element is at the beginning of the storage
+template <class T, int N>
+T *StaticCircularBuffer<T, N>::linearize() {
+    if (!is_linearized()) {
+        // The storage is small, so going through a temporary copy is cheap
+        StaticCircularBuffer moved(std::move(*this));
+        *this = std::move(moved);
+    }
+    return slots();
+}
+
+// Checks if the buffer is linearized
+template <class T, int N>
+bool StaticCircularBuffer<T, N>::is_linearized() const {
+    return start == 0;
+}
+
+// Returns the number of elements stored in the buffer
+template <class T, int N>
+int StaticCircularBuffer<T, N>::size() const {
+    return count;
+}
+
+// Checks if the buffer is empty
+template <class T, int N>
+bool StaticCircularBuffer<T, N>::empty() const {
+    return count == 0;
+}
+
+// Checks if the buffer is full (size == capacity)
+template <class T, int N>
+bool StaticCircularBuffer<T, N>::full() const {
+    return count == N;
+}
+
+// Returns the number of free slots in the buffer
+template <class T, int N>
+int StaticCircularBuffer<T, N>::reserve() const {
+    return N - count;
+}
+
+// Swaps the contents of the buffer with another buffer
+template <class T, int N>
+void StaticCircularBuffer<T, N>::swap(StaticCircularBuffer &cb) {
+    StaticCircularBuffer tmp(std::move(cb));
+    cb = std::move(*this);
+    *this = std::move(tmp);
+}
+
+// Adds an element to the end of the buffer
+// If the buffer is full, the first element is overwritten
+template <class T, int N>
+void StaticCircularBuffer<T, N>::push_back(const value_type &item) {
+    store_back(item);
+}
+
+template <class T, int N>
+void StaticCircularBuffer<T, N>::push_back(value_type &&item) {
+    store_back(std::move(item));
+}
+
+// Adds a new element before the first element of the buffer
+// If the buffer is full, the last element is overwritten
+template <class T, int N>
+void StaticCircularBuffer<T, N>::push_front(const value_type &item) {
+    store_front(item);
+}
+
+template <class T, int N>
+void StaticCircularBuffer<T, N>::push_front(value_type &&item) {
+    store_front(std::move(item));
+}
+
+// Constructs an element in place after the last element
+// If the buffer is full, the first element is overwritten by a temporary built from args
+template <class T, int N>
+template <class... Args>
+T &StaticCircularBuffer<T, N>::emplace_back(Args &&...args) {
+    if (full()) {
+        store_back(value_type(std::forward<Args>(args)...));
+    } else {
+        ::new (static_cast<void*>(slots() + index(count))) T(std::forward<Args>(args)...);
+        ++count;
+    }
+    return back();
+}
+
+// Constructs an element in place before the first element
+// If the buffer is full, the last element is overwritten by a temporary built from args
+template <class T, int N>
+template <class... Args>
+T &StaticCircularBuffer<T, N>::emplace_front(Args &&...args) {
+    if (full()) {
+        store_front(value_type(std::forward<Args>(args)...));
+    } else {
+        int new_start = wrap(start + N - 1);
+        ::new (static_cast<void*>(slots() + new_start)) T(std::forward<Args>(args)...);
+        start = new_start;
+        ++count;
+    }
+    return front();
+}
+
+// Removes the last element of the buffer
+template <class T, int N>
+void StaticCircularBuffer<T, N>::pop_back() {
+    if (empty()) {
+        throw std::runtime_error("Buffer is empty");
+    }
+    slots()[index(count - 1)].~T();
+    --count;
+}
+
+// Removes the first element of the buffer
+template <class T, int N>
+void StaticCircularBuffer<T, N>::pop_front() {
+    if (empty()) {
+        throw std::runtime_error("Buffer is empty");
+    }
+    slots()[start].~T();
+    start = wrap(start + 1);
+    --count;
+}
+
+// Inserts an element at the specified position
+// The capacity of the buffer remains unchanged
+template <class T, int N>
+void StaticCircularBuffer<T, N>::insert(int pos, const value_type &item) {
+    insert(pos, value_type(item));
+}
+
+template <class T, int N>
+void StaticCircularBuffer<T, N>::insert(int pos, value_type &&item) {
+    if (pos < 0 || pos > count) {
+        throw std::out_of_range("Position out of range");
+    }
+    if (full()) {
+        throw std::runtime_error("Buffer is full");
+    }
+    if (pos == count) {
+        emplace_back(std::move(item));
+        return;
+    }
+    // Shift elements to make room; the slot after the last element is raw storage
+    ::new (static_cast<void*>(slots() + index(count))) T(std::move(slots()[index(count - 1)]));
+    for (int i = count - 1; i > pos; --i) {
+        slots()[index(i)] = std::move(slots()[index(i - 1)]);
+    }
+    slots()[index(pos)] = std::move(item);
+    ++count;
+}
+
+// Erases elements in the range [first, last)
+template <class T, int N>
+void StaticCircularBuffer<T, N>::erase(int first, int last) {
+    if (first < 0 || last > count || first >= last) {
+        throw std::out_of_range("Invalid range");
+    }
+    int num_erased = last - first;
+    // Shift elements to close the gap
+    for (int i = first; i < count - num_erased; ++i) {
+        slots()[index(i)] = std::move(slots()[index(i + num_erased)]);
+    }
+    for (int i = 0; i < num_erased; ++i) {
+        pop_back();
+    }
+}
+
+// Clears the buffer
+template <class T, int N>
+void StaticCircularBuffer<T, N>::clear() {
+    if constexpr (!std::is_trivially_destructible<value_type>::value) {
+        for (int i = 0; i < count; ++i) {
+            slots()[index(i)].~T();
+        }
+    }
+    start = 0;
+    count = 0;
+}
+
+// Iterators over the elements in logical order
+template <class T, int N>
+typename StaticCircularBuffer<T, N>::iterator StaticCircularBuffer<T, N>::begin() {
+    return iterator(slots(), N, start, 0);
+}
+
+template <class T, int N>
+typename StaticCircularBuffer<T, N>::iterator StaticCircularBuffer<T, N>::end() {
+    return iterator(slots(), N, start, count);
+}
+
+template <class T, int N>
+typename StaticCircularBuffer<T, N>::const_iterator StaticCircularBuffer<T, N>::begin() const {
+    return const_iterator(slots(), N, start, 0);
+}
+
+template <class T, int N>
+typename StaticCircularBuffer<T, N>::const_iterator StaticCircularBuffer<T, N>::end() const {
+    return const_iterator(slots(), N, start, count);
+}
+
+template <class T, int N>
+typename StaticCircularBuffer<T, N>::const_iterator StaticCircularBuffer<T, N>::cbegin() const {
+    return begin();
+}
+
+template <class T, int N>
+typename StaticCircularBuffer<T, N>::const_iterator StaticCircularBuffer<T, N>::cend() const {
+    return end();
+}
+
+template <class T, int N>
+typename StaticCircularBuffer<T, N>::reverse_iterator StaticCircularBuffer<T, N>::rbegin() {
+    return reverse_iterator(end());
+}
+
+template <class T, int N>
+typename StaticCircularBuffer<T, N>::reverse_iterator StaticCircularBuffer<T, N>::rend() {
+    return reverse_iterator(begin());
+}
+
+template <class T, int N>
+typename StaticCircularBuffer<T, N>::const_reverse_iterator StaticCircularBuffer<T, N>::rbegin() const {
+    return const_reverse_iterator(end());
+}
+
+template <class T, int N>
+typename StaticCircularBuffer<T, N>::const_reverse_iterator StaticCircularBuffer<T, N>::rend() const {
+    return const_reverse_iterator(begin());
+}
+
+// Equality operators
+template <class T, int N>
+bool operator==(const StaticCircularBuffer<T, N> &a, const StaticCircularBuffer<T, N> &b) {
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+}
+
+template <class T, int N>
+bool operator!=(const StaticCircularBuffer<T, N> &a, const StaticCircularBuffer<T, N> &b) {
+    return !(a == b);
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// 32-bit counter that threads can sleep on until another thread changes it.
+// Uses futex on Linux, so sleeping and waking cost one syscall each and a
+// wake with no sleepers costs none when guarded by a waiter count.
+// Other platforms fall back to short sleeps.
+class WaitWord {
+private:
+    std::atomic<std::uint32_t> word;   // Current value; only ever incremented
+
+public:
+    // Constructs a word with value zero
+    WaitWord();
+
+    WaitWord(const WaitWord&) = delete;
+    WaitWord& operator=(const WaitWord&) = delete;
+
+    // Returns the current value
+    std::uint32_t load() const;
+
+    // Sleeps while the value equals expected; may return spuriously
+    void wait(std::uint32_t expected);
+
+    // Sleeps while the value equals expected, at most until deadline
+    // Returns false if the deadline has passed; may return true spuriously
+    bool wait_until(std::uint32_t expected, std::chrono::steady_clock::time_point deadline);
+
+    // Changes the value and wakes up to n sleeping threads, all of them if n is negative
+    void notify(int n);
+};
@@ -0,0 +1,87 @@
+#include "buffer-stats.h"
+
+#include <sstream>
+
+// Returns the counters as "name value" lines
+std::string BufferStatsSnapshot::to_text() const {
+    std::ostringstream out;
+    out << "capacity " << capacity << '\n'
+        << "pushes " << pushes << '\n'
+        << "pops " << pops << '\n'
+        << "overwrites " << overwrites << '\n'
+        << "high_water " << high_water << '\n'
+        << "time_at_full_ns " << time_at_full.count() << '\n';
+    for (int i = 0; i < histogram_buckets; ++i) {
+        // Bucket bounds in percent of the capacity
+        out << "occupancy_" << i * 100 / histogram_buckets << '_' << (i + 1) * 100 / histogram_buckets << ' '
+            << occupancy[i] << '\n';
+    }
+    return out.str();
+}
+
+// Returns the counters as a single-line JSON object
+std::string BufferStatsSnapshot::to_json() const {
+    std::ostringstream out;
+    out << "{\"capacity\":" << capacity
+        << ",\"pushes\":" << pushes
+        << ",\"pops\":" << pops
+        << ",\"overwrites\":" << overwrites
+        << ",\"high_water\":" << high_water
+        << ",\"time_at_full_ns\":" << time_at_full.count()
+        << ",\"occupancy\":[";
+    for (int i = 0; i < histogram_buckets; ++i) {
+        out << (i ? "," : "") << occupancy[i];
+    }
+    out << "]}";
+    return out.str();
+}
+
+// Constructs zeroed counters for a buffer of the given capacity
+BufferStats::BufferStats(int capacity)
+    : cap(capacity), bucket(0), pushes(0), pops(0), overwrites(0), high_water(0), full_since(-1), full_ticks(0) {
+    for (auto &counter : occupancy) {
+        counter.store(0, std::memory_order_relaxed);
+    }
+    // Bucket i holds the sizes with i * cap / histogram_buckets <= size, rounded up
+    const int buckets = BufferStatsSnapshot::histogram_buckets;
+    bounds[0] = 0;
+    for (int i = 1; i < buckets; ++i) {
+        bounds[i] = static_cast<int>((static_cast<std::int64_t>(i) * cap + buckets - 1) / buckets);
+    }
+    bounds[buckets] = cap + 1;
+}
+
+// Returns a copy of the counters; safe to call from any thread
+BufferStatsSnapshot BufferStats::snapshot() const {
+    BufferStatsSnapshot s;
+    s.capacity = cap;
+    s.pushes = pushes.load(std::memory_order_relaxed);
+    s.pops = pops.load(std::memory_order_relaxed);
+    s.overwrites = overwrites.load(std::memory_order_relaxed);
+    s.high_water = high_water.load(std::memory_order_relaxed);
+    for (int i = 0; i < BufferStatsSnapshot::histogram_buckets; ++i) {
+        s.occupancy[i] = occupancy[i].load(std::memory_order_relaxed);
+    }
+    std::int64_t ticks = full_ticks.load(std::memory_order_relaxed);
+    std::int64_t since = full_since.load(std::memory_order_relaxed);
+    if (since >= 0) {
+        // Still full: count the ongoing stretch as well
+        ticks += clock::now().time_since_epoch().count() - since;
+    }
+    s.time_at_full = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::duration(ticks));
+    return s;
+}
+
+// Zeroes the counters, keeping the current fullness; only from the owning thread
+void BufferStats::reset(int size) {
+    pushes.store(0, std::memory_order_relaxed);
+    pops.store(0, std::memory_order_relaxed);
+    overwrites.store(0, std::memory_order_relaxed);
+    high_water.store(size, std::memory_order_relaxed);
+    for (auto &counter : occupancy) {
+        counter.store(0, std::memory_order_relaxed);
+    }
+    full_ticks.store(0, std::memory_order_relaxed);
+    full_since.store(size == cap && cap > 0 ? clock::now().time_since_epoch().count() : -1,
+                     std::memory_order_relaxed);
+}
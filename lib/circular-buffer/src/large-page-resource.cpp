@@ -0,0 +1,180 @@
+#include "large-page-resource.h"
+
+#include <cstdint>
+#include <fstream>
+#include <new>
+#include <sstream>
+#include <string>
+
+#ifdef __linux__
+#include <linux/mempolicy.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Constructs a resource with the given options
+LargePageResource::LargePageResource(const LargePageOptions &options)
+    : options(options), granule(4096), base_page(4096) {
+#ifdef __linux__
+    base_page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    granule = base_page;
+    std::size_t huge = huge_page_size();
+    if (options.huge_pages && huge > granule) {
+        granule = huge;
+    }
+#endif
+}
+
+// Returns the options given at construction
+const LargePageOptions &LargePageResource::get_options() const {
+    return options;
+}
+
+// Returns what the last allocation actually obtained
+PageBackingInfo LargePageResource::last_backing() const {
+    std::lock_guard<std::mutex> lock(last_mutex);
+    return last;
+}
+
+// Returns the default huge page size of the system, 0 if unknown
+std::size_t LargePageResource::huge_page_size() {
+    std::ifstream meminfo("/proc/meminfo");
+    std::string key;
+    std::size_t kib;
+    while (meminfo >> key) {
+        if (key == "Hugepagesize:" && meminfo >> kib) {
+            return kib * 1024;
+        }
+        meminfo.ignore(256, '\n');
+    }
+    return 0;
+}
+
+bool LargePageResource::do_is_equal(const std::pmr::memory_resource &other) const noexcept {
+    return this == &other;
+}
+
+#ifdef __linux__
+
+// Maps bytes of anonymous memory aligned to alignment, nullptr on failure
+static void* map_aligned(std::size_t bytes, std::size_t alignment) {
+    // Over-map and trim so that the mapping starts on an alignment boundary
+    std::size_t padded = bytes + alignment;
+    void* raw = mmap(nullptr, padded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) {
+        return nullptr;
+    }
+    auto begin = reinterpret_cast<std::uintptr_t>(raw);
+    std::uintptr_t aligned = (begin + alignment - 1) / alignment * alignment;
+    if (aligned > begin) {
+        munmap(raw, aligned - begin);
+    }
+    std::uintptr_t tail = begin + padded - (aligned + bytes);
+    if (tail > 0) {
+        munmap(reinterpret_cast<void*>(aligned + bytes), tail);
+    }
+    return reinterpret_cast<void*>(aligned);
+}
+
+// Checks in /proc/self/smaps whether the mapping holding p has anonymous huge pages
+static bool has_anon_huge_pages(void* p) {
+    std::ifstream smaps("/proc/self/smaps");
+    auto address = reinterpret_cast<std::uintptr_t>(p);
+    std::string line;
+    bool inside = false;
+    while (std::getline(smaps, line)) {
+        std::uintptr_t begin, end;
+        char dash;
+        std::istringstream header(line);
+        // Mapping headers start with "begin-end", in hex
+        if (line.find(':') > line.find(' ') && header >> std::hex >> begin >> dash >> end && dash == '-') {
+            inside = begin <= address && address < end;
+        } else if (inside && line.compare(0, 14, "AnonHugePages:") == 0) {
+            std::size_t kib = 0;
+            std::istringstream(line.substr(14)) >> kib;
+            return kib > 0;
+        }
+    }
+    return false;
+}
+
+void* LargePageResource::do_allocate(std::size_t bytes, std::size_t alignment) {
+    std::size_t length = (bytes + granule - 1) / granule * granule;
+    if (length == 0) {
+        length = granule;
+    }
+    if (alignment > granule) {
+        throw std::bad_alloc();
+    }
+    PageBackingInfo info;
+    bool transparent = false;
+
+    void* p = MAP_FAILED;
+    if (options.huge_pages && granule > static_cast<std::size_t>(sysconf(_SC_PAGESIZE))) {
+        p = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (p != MAP_FAILED) {
+            info.backing = PageBacking::Explicit;
+        } else {
+            // No reserved huge pages, ask for transparent ones on a huge page boundary
+            p = map_aligned(length, granule);
+            if (!p) {
+                throw std::bad_alloc();
+            }
+            transparent = madvise(p, length, MADV_HUGEPAGE) == 0;
+        }
+    } else {
+        p = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+    }
+
+    if (options.numa_node >= 0) {
+        // The binding must be set before the pages are first touched
+        const unsigned long bits = 8 * sizeof(unsigned long);
+        unsigned long mask[16] = {};
+        if (static_cast<unsigned long>(options.numa_node) < 16 * bits) {
+            mask[options.numa_node / bits] = 1ul << (options.numa_node % bits);
+            info.numa_bound = syscall(SYS_mbind, p, length, MPOL_BIND, mask, 16 * bits, 0) == 0;
+        }
+    }
+    if (options.lock) {
+        info.locked = mlock(p, length) == 0;
+    }
+    if (transparent) {
+        // The kernel picks the page size on the first fault, after the binding above
+        *static_cast<volatile char*>(p) = 0;
+        if (has_anon_huge_pages(p)) {
+            info.backing = PageBacking::Transparent;
+        }
+    }
+    info.page_size = info.backing == PageBacking::Regular ? base_page : granule;
+
+    std::lock_guard<std::mutex> lock(last_mutex);
+    last = info;
+    return p;
+}
+
+void LargePageResource::do_deallocate(void *p, std::size_t bytes, std::size_t) {
+    std::size_t length = (bytes + granule - 1) / granule * granule;
+    if (length == 0) {
+        length = granule;
+    }
+    munmap(p, length);
+}
+
+#else
+
+void* LargePageResource::do_allocate(std::size_t bytes, std::size_t alignment) {
+    std::lock_guard<std::mutex> lock(last_mutex);
+    last = PageBackingInfo();
+    last.page_size = base_page;
+    return ::operator new(bytes, std::align_val_t(alignment));
+}
+
+void LargePageResource::do_deallocate(void *p, std::size_t, std::size_t alignment) {
+    ::operator delete(p, std::align_val_t(alignment));
+}
+
+#endif
@@ -0,0 +1,184 @@
+#include "masked-circular-buffer.h"
+
+// Rounds a capacity up to the next power of two
+static unsigned round_up_pow2(int capacity) {
+    if (capacity < 0) {
+        throw std::invalid_argument("Capacity must be non-negative");
+    }
+    if (capacity > (1 << 30)) {
+        throw std::invalid_argument("Capacity is too large");
+    }
+    unsigned cap = 1;
+    while (cap < static_cast<unsigned>(capacity)) {
+        cap <<= 1;
+    }
+    return capacity == 0 ? 0 : cap;
+}
+
+// Default constructor
+MaskedCircularBuffer::MaskedCircularBuffer()
+    : buffer(nullptr), cap(0), mask(0), head(0), tail(0) {}
+
+// Destructor
+MaskedCircularBuffer::~MaskedCircularBuffer() {
+    delete[] buffer;
+}
+
+// Copy constructor
+MaskedCircularBuffer::MaskedCircularBuffer(const MaskedCircularBuffer &cb)
+    : cap(cb.cap), mask(cb.mask), head(cb.head), tail(cb.tail) {
+    buffer = new value_type[cap];
+    for (unsigned i = head; i != tail; ++i) {
+        buffer[i & mask] = cb.buffer[i & mask];
+    }
+}
+
+// Constructs a buffer with at least the given capacity, rounded up to a power of two
+MaskedCircularBuffer::MaskedCircularBuffer(int capacity)
+    : buffer(nullptr), cap(round_up_pow2(capacity)), head(0), tail(0) {
+    mask = cap - 1;
+    buffer = new value_type[cap];
+}
+
+// Assignment operator
+MaskedCircularBuffer &MaskedCircularBuffer::operator=(const MaskedCircularBuffer &cb) {
+    if (this != &cb) {
+        MaskedCircularBuffer copy(cb);
+        swap(copy);
+    }
+    return *this;
+}
+
+// Access by index without bounds checking
+MaskedCircularBuffer::value_type &MaskedCircularBuffer::operator[](int i) {
+    return buffer[(head + i) & mask];
+}
+
+const MaskedCircularBuffer::value_type &MaskedCircularBuffer::operator[](int i) const {
+    return buffer[(head + i) & mask];
+}
+
+// Access by index with bounds checking
+MaskedCircularBuffer::value_type &MaskedCircularBuffer::at(int i) {
+    if (i < 0 || i >= size()) {
+        throw std::out_of_range("Index out of range");
+    }
+    return (*this)[i];
+}
+
+const MaskedCircularBuffer::value_type &MaskedCircularBuffer::at(int i) const {
+    if (i < 0 || i >= size()) {
+        throw std::out_of_range("Index out of range");
+    }
+    return (*this)[i];
+}
+
+// Reference to the first element
+MaskedCircularBuffer::value_type &MaskedCircularBuffer::front() {
+    if (empty()) {
+        throw std::runtime_error("Buffer is empty");
+    }
+    return buffer[head & mask];
+}
+
+const MaskedCircularBuffer::value_type &MaskedCircularBuffer::front() const {
+    if (empty()) {
+        throw std::runtime_error("Buffer is empty");
+    }
+    return buffer[head & mask];
+}
+
+// Reference to the last element
+MaskedCircularBuffer::value_type &MaskedCircularBuffer::back() {
+    if (empty()) {
+        throw std::runtime_error("Buffer is empty");
+    }
+    return buffer[(tail - 1) & mask];
+}
+
+const MaskedCircularBuffer::value_type &MaskedCircularBuffer::back() const {
+    if (empty()) {
+        throw std::runtime_error("Buffer is empty");
+    }
+    return buffer[(tail - 1) & mask];
+}
+
+// Returns the number of elements stored in the buffer
+int MaskedCircularBuffer::size() const {
+    return static_cast<int>(tail - head);
+}
+
+// Checks if the buffer is empty
+bool MaskedCircularBuffer::empty() const {
+    return tail == head;
+}
+
+// Checks if the buffer is full (size == capacity)
+bool MaskedCircularBuffer::full() const {
+    return tail - head == cap;
+}
+
+// Returns the number of free slots in the buffer
+int MaskedCircularBuffer::reserve() const {
+    return static_cast<int>(cap - (tail - head));
+}
+
+// Returns the capacity of the buffer
+int MaskedCircularBuffer::capacity() const {
+    return static_cast<int>(cap);
+}
+
+// Swaps the contents of the buffer with another buffer
+void MaskedCircularBuffer::swap(MaskedCircularBuffer &cb) {
+    std::swap(buffer, cb.buffer);
+    std::swap(cap, cb.cap);
+    std::swap(mask, cb.mask);
+    std::swap(head, cb.head);
+    std::swap(tail, cb.tail);
+}
+
+// Adds an element to the end of the buffer
+// If the buffer is full, the first element is overwritten
+void MaskedCircularBuffer::push_back(const value_type &item) {
+    if (cap == 0) {
+        throw std::runtime_error("Buffer capacity is zero");
+    }
+    if (full()) {
+        ++head;
+    }
+    buffer[tail++ & mask] = item;
+}
+
+// Adds a new element before the first element of the buffer
+// If the buffer is full, the last element is overwritten
+void MaskedCircularBuffer::push_front(const value_type &item) {
+    if (cap == 0) {
+        throw std::runtime_error("Buffer capacity is zero");
+    }
+    if (full()) {
+        --tail;
+    }
+    buffer[--head & mask] = item;
+}
+
+// Removes the last element of the buffer
+void MaskedCircularBuffer::pop_back() {
+    if (empty()) {
+        throw std::runtime_error("Buffer is empty");
+    }
+    --tail;
+}
+
+// Removes the first element of the buffer
+void MaskedCircularBuffer::pop_front() {
+    if (empty()) {
+        throw std::runtime_error("Buffer is empty");
+    }
+    ++head;
+}
+
+// Clears the buffer
+void MaskedCircularBuffer::clear() {
+    head = 0;
+    tail = 0;
+}
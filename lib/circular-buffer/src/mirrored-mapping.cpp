@@ -0,0 +1,133 @@
+#include "mirrored-mapping.h"
+
+#include <cerrno>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+// Greatest common divisor used to combine the page size with the element size
+static std::size_t gcd(std::size_t a, std::size_t b) {
+    while (b != 0) {
+        std::size_t t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+// Creates an empty mapping
+MirroredMapping::MirroredMapping() : base(nullptr), length(0) {}
+
+#ifdef __linux__
+
+// Maps at least min_bytes, rounded up to a multiple of unit and of the page size
+MirroredMapping::MirroredMapping(std::size_t min_bytes, std::size_t unit)
+    : base(nullptr), length(0) {
+    if (min_bytes == 0) {
+        return;
+    }
+    if (unit == 0) {
+        throw std::invalid_argument("unit must be positive");
+    }
+    std::size_t page = page_size();
+    std::size_t granule = page / gcd(page, unit) * unit;
+    std::size_t bytes = (min_bytes + granule - 1) / granule * granule;
+
+    int fd = memfd_create("circular-buffer", MFD_CLOEXEC);
+    if (fd < 0) {
+        throw std::system_error(errno, std::generic_category(), "memfd_create failed");
+    }
+    if (ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+        int err = errno;
+        close(fd);
+        throw std::system_error(err, std::generic_category(), "ftruncate failed");
+    }
+
+    // Reserve an address range for both copies, then map the file over each half
+    void* reserved = mmap(nullptr, 2 * bytes, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (reserved == MAP_FAILED) {
+        int err = errno;
+        close(fd);
+        throw std::system_error(err, std::generic_category(), "mmap reservation failed");
+    }
+    auto* first = static_cast<unsigned char*>(reserved);
+    if (mmap(first, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED ||
+        mmap(first + bytes, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED) {
+        int err = errno;
+        munmap(reserved, 2 * bytes);
+        close(fd);
+        throw std::system_error(err, std::generic_category(), "mmap of the mirror failed");
+    }
+    // The mappings keep the memory alive
+    close(fd);
+
+    base = first;
+    length = bytes;
+}
+
+// Destructor
+MirroredMapping::~MirroredMapping() {
+    if (base) {
+        munmap(base, 2 * length);
+    }
+}
+
+// Returns the system page size
+std::size_t MirroredMapping::page_size() {
+    return static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+}
+
+#else
+
+// Maps at least min_bytes, rounded up to a multiple of unit and of the page size
+MirroredMapping::MirroredMapping(std::size_t min_bytes, std::size_t unit)
+    : base(nullptr), length(0) {
+    (void)unit;
+    if (min_bytes != 0) {
+        throw std::runtime_error("Mirrored mappings are only supported on Linux");
+    }
+}
+
+// Destructor
+MirroredMapping::~MirroredMapping() {}
+
+// Returns the system page size
+std::size_t MirroredMapping::page_size() {
+    return 4096;
+}
+
+#endif
+
+// Move constructor and assignment
+MirroredMapping::MirroredMapping(MirroredMapping &&other) noexcept
+    : base(other.base), length(other.length) {
+    other.base = nullptr;
+    other.length = 0;
+}
+
+MirroredMapping &MirroredMapping::operator=(MirroredMapping &&other) noexcept {
+    MirroredMapping moved(std::move(other));
+    swap(moved);
+    return *this;
+}
+
+// Start of the mapping; valid for 2 * size() bytes
+unsigned char *MirroredMapping::data() const {
+    return base;
+}
+
+// Length of one copy in bytes
+std::size_t MirroredMapping::size() const {
+    return length;
+}
+
+// Swaps two mappings
+void MirroredMapping::swap(MirroredMapping &other) noexcept {
+    std::swap(base, other.base);
+    std::swap(length, other.length);
+}
@@ -0,0 +1,110 @@
+#include "record-ring.h"
+
+#include <stdexcept>
+
+constexpr int RecordRing::alignment;
+constexpr RecordRing::header_type RecordRing::skip_marker;
+
+// Constructs a ring of the given size in bytes, rounded up to a multiple of alignment
+RecordRing::RecordRing(int capacity) : records(0) {
+    if (capacity < 0) {
+        throw std::invalid_argument("Capacity must be non-negative");
+    }
+    if (capacity > INT_MAX - alignment) {
+        throw std::invalid_argument("Capacity is too large");
+    }
+    ring = CircularBuffer<char>((capacity + alignment - 1) / alignment * alignment);
+}
+
+// Appends a copy of data[0, size) as one record
+// Returns false if the ring has no room for it right now
+bool RecordRing::push_record(const void *data, std::size_t size) {
+    if (size > max_record_size()) {
+        throw std::invalid_argument("Record is larger than the ring");
+    }
+    std::size_t framed = framed_size(size);
+    auto spans = ring.write_regions();
+    char *dest = spans[0].data;
+    int skip = 0;
+    if (static_cast<std::size_t>(spans[0].size) < framed) {
+        // Pad the tail of the storage and start over at the beginning
+        if (static_cast<std::size_t>(spans[1].size) < framed) {
+            return false;
+        }
+        if (spans[0].size > 0) {
+            std::memcpy(spans[0].data, &skip_marker, sizeof(skip_marker));
+        }
+        skip = spans[0].size;
+        dest = spans[1].data;
+    }
+    header_type h = static_cast<header_type>(size);
+    std::memcpy(dest, &h, sizeof(h));
+    if (size > 0) {
+        std::memcpy(dest + sizeof(h), data, size);
+    }
+    // Padding and record are published together
+    ring.commit_write(skip + static_cast<int>(framed));
+    ++records;
+    return true;
+}
+
+// Returns the header of the first record and the bytes of padding before it
+const char *RecordRing::first_record(int &skipped) const {
+    if (records == 0) {
+        throw std::runtime_error("Buffer is empty");
+    }
+    auto spans = ring.read_regions();
+    skipped = 0;
+    if (read_header(spans[0].data) == skip_marker) {
+        skipped = spans[0].size;
+        return spans[1].data;
+    }
+    return spans[0].data;
+}
+
+// Returns the first record without removing it
+RecordView RecordRing::peek_record() const {
+    int skipped;
+    const char *p = first_record(skipped);
+    return RecordView{p + sizeof(header_type), read_header(p)};
+}
+
+// Removes the first record
+void RecordRing::pop_record() {
+    int skipped;
+    const char *p = first_record(skipped);
+    ring.consume(skipped + static_cast<int>(framed_size(read_header(p))));
+    --records;
+}
+
+// Returns the number of records in the ring
+int RecordRing::size() const {
+    return records;
+}
+
+// Checks if the ring holds no records
+bool RecordRing::empty() const {
+    return records == 0;
+}
+
+// Returns the number of bytes in use, including headers and padding
+int RecordRing::bytes_used() const {
+    return ring.size();
+}
+
+// Returns the capacity of the ring in bytes
+int RecordRing::capacity() const {
+    return ring.capacity();
+}
+
+// Returns the largest payload the ring can ever hold
+std::size_t RecordRing::max_record_size() const {
+    int cap = ring.capacity();
+    return cap < static_cast<int>(sizeof(header_type)) ? 0 : static_cast<std::size_t>(cap) - sizeof(header_type);
+}
+
+// Removes all records
+void RecordRing::clear() {
+    ring.clear();
+    records = 0;
+}
@@ -0,0 +1,195 @@
+#include "ring-file.h"
+
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static const char ring_file_magic[8] = {'C', 'B', 'R', 'I', 'N', 'G', 0, 0};
+
+// Creates an empty mapping
+RingFile::RingFile() : base(nullptr), length(0), can_write(false) {}
+
+#ifdef __linux__
+
+// Closes fd and throws a system_error for the current errno
+[[noreturn]] static void fail(int fd, const char *what) {
+    int err = errno;
+    if (fd >= 0) {
+        close(fd);
+    }
+    throw std::system_error(err, std::generic_category(), what);
+}
+
+// Opens the ring at path holding capacity elements of element_size bytes
+// A capacity of zero takes the capacity from an existing file
+RingFile::RingFile(const std::string &path, std::size_t element_size, std::size_t element_align,
+                   std::uint64_t capacity, RingFileMode mode)
+    : base(nullptr), length(0), can_write(mode != RingFileMode::ReadOnly) {
+    if (element_size == 0 || element_align == 0 || element_align > 64) {
+        throw std::invalid_argument("Unsupported element type");
+    }
+    int flags = can_write ? O_RDWR : O_RDONLY;
+    if (mode == RingFileMode::OpenOrCreate) {
+        flags |= O_CREAT;
+    }
+    int fd = open(path.c_str(), flags | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        fail(-1, "Cannot open the ring file");
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        fail(fd, "fstat failed");
+    }
+
+    bool fresh = st.st_size == 0;
+    if (fresh) {
+        if (mode != RingFileMode::OpenOrCreate) {
+            close(fd);
+            throw std::runtime_error("Not a ring file");
+        }
+        if (capacity == 0) {
+            close(fd);
+            throw std::invalid_argument("Capacity must be positive");
+        }
+        // Slot 0 starts on a cache line after the header
+        std::uint64_t offset = (sizeof(RingFileHeader) + 63) / 64 * 64;
+        std::uint64_t bytes = offset + capacity * element_size;
+        if (ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+            fail(fd, "ftruncate failed");
+        }
+        length = static_cast<std::size_t>(bytes);
+    } else {
+        RingFileHeader probe;
+        if (st.st_size < static_cast<off_t>(sizeof(RingFileHeader)) ||
+            pread(fd, &probe, sizeof(probe), 0) != static_cast<ssize_t>(sizeof(probe)) ||
+            std::memcmp(probe.magic, ring_file_magic, sizeof(ring_file_magic)) != 0) {
+            close(fd);
+            throw std::runtime_error("Not a ring file");
+        }
+        if (probe.version != ring_file_version) {
+            close(fd);
+            throw std::runtime_error("Unsupported ring file version");
+        }
+        if (probe.element_size != element_size || probe.data_offset % element_align != 0 ||
+            (capacity != 0 && probe.capacity != capacity) ||
+            static_cast<std::uint64_t>(st.st_size) < probe.data_offset + probe.capacity * element_size) {
+            close(fd);
+            throw std::runtime_error("Ring file has an incompatible layout");
+        }
+        length = static_cast<std::size_t>(probe.data_offset + probe.capacity * element_size);
+    }
+
+    int prot = can_write ? PROT_READ | PROT_WRITE : PROT_READ;
+    void *mapped = mmap(nullptr, length, prot, MAP_SHARED, fd, 0);
+    if (mapped == MAP_FAILED) {
+        length = 0;
+        fail(fd, "mmap of the ring file failed");
+    }
+    // The mapping keeps the file open
+    close(fd);
+    base = static_cast<unsigned char *>(mapped);
+
+    RingFileHeader *h = header();
+    if (fresh) {
+        std::memcpy(h->magic, ring_file_magic, sizeof(ring_file_magic));
+        h->version = ring_file_version;
+        h->element_size = static_cast<std::uint32_t>(element_size);
+        h->capacity = capacity;
+        h->data_offset = (sizeof(RingFileHeader) + 63) / 64 * 64;
+        ::new (static_cast<void *>(&h->first)) std::atomic<std::uint64_t>(0);
+        ::new (static_cast<void *>(&h->last)) std::atomic<std::uint64_t>(0);
+    } else if (can_write) {
+        // Repair counters that no sequence of interrupted updates can produce
+        std::uint64_t first = h->first.load(std::memory_order_relaxed);
+        std::uint64_t last = h->last.load(std::memory_order_relaxed);
+        if (first > last) {
+            h->first.store(last, std::memory_order_relaxed);
+        } else if (last - first > h->capacity) {
+            h->first.store(last - h->capacity, std::memory_order_relaxed);
+        }
+    }
+}
+
+// Destructor
+RingFile::~RingFile() {
+    if (base) {
+        munmap(base, length);
+    }
+}
+
+// Flushes the mapping to the file, waiting for the write if wait is true
+void RingFile::sync(bool wait) {
+    if (base && can_write && msync(base, length, wait ? MS_SYNC : MS_ASYNC) != 0) {
+        throw std::system_error(errno, std::generic_category(), "msync failed");
+    }
+}
+
+#else
+
+// Opens the ring at path holding capacity elements of element_size bytes
+// A capacity of zero takes the capacity from an existing file
+RingFile::RingFile(const std::string &path, std::size_t element_size, std::size_t element_align,
+                   std::uint64_t capacity, RingFileMode mode)
+    : base(nullptr), length(0), can_write(false) {
+    (void)path;
+    (void)element_size;
+    (void)element_align;
+    (void)capacity;
+    (void)mode;
+    throw std::runtime_error("Ring files are only supported on Linux");
+}
+
+// Destructor
+RingFile::~RingFile() {}
+
+// Flushes the mapping to the file, waiting for the write if wait is true
+void RingFile::sync(bool wait) {
+    (void)wait;
+}
+
+#endif
+
+// Move constructor and assignment
+RingFile::RingFile(RingFile &&other) noexcept : base(other.base), length(other.length), can_write(other.can_write) {
+    other.base = nullptr;
+    other.length = 0;
+    other.can_write = false;
+}
+
+RingFile &RingFile::operator=(RingFile &&other) noexcept {
+    RingFile moved(std::move(other));
+    swap(moved);
+    return *this;
+}
+
+// Header at the start of the mapping
+RingFileHeader *RingFile::header() const {
+    return reinterpret_cast<RingFileHeader *>(base);
+}
+
+// Start of the element slots
+unsigned char *RingFile::data() const {
+    return base ? base + header()->data_offset : nullptr;
+}
+
+// Checks if the ring may be modified
+bool RingFile::writable() const {
+    return can_write;
+}
+
+// Swaps two mappings
+void RingFile::swap(RingFile &other) noexcept {
+    std::swap(base, other.base);
+    std::swap(length, other.length);
+    std::swap(can_write, other.can_write);
+}
@@ -0,0 +1,256 @@
+#include "shared-spsc-circular-buffer.h"
+
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <system_error>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static const char shared_ring_magic[8] = {'C', 'B', 'S', 'H', 'M', 0, 0, 0};
+static const std::uint32_t shared_ring_version = 1;
+
+// Slot 0 starts on a cache line after the header
+static const std::size_t shared_ring_data_offset =
+    (sizeof(SharedRingHeader) + SharedRingHeader::cache_line - 1) / SharedRingHeader::cache_line *
+    SharedRingHeader::cache_line;
+
+#ifdef __linux__
+
+// Closes fd and throws a system_error for the current errno
+[[noreturn]] static void fail(int fd, const char *what) {
+    int err = errno;
+    if (fd >= 0) {
+        close(fd);
+    }
+    throw std::system_error(err, std::generic_category(), what);
+}
+
+// Creates a segment with the given name and capacity, replacing a stale one
+// The name must start with a slash, as required by shm_open
+SharedSpscCircularBuffer::SharedSpscCircularBuffer(const std::string &name, int capacity)
+    : header(nullptr), slots(nullptr), length(0), cap(0), segment(name), owner(true), cached_head(0),
+      cached_tail(0) {
+    if (capacity < 0) {
+        throw std::invalid_argument("Capacity must be non-negative");
+    }
+    cap = static_cast<std::size_t>(capacity);
+    shm_unlink(name.c_str());
+    int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+    if (fd < 0) {
+        fail(-1, "shm_open failed");
+    }
+    length = shared_ring_data_offset + cap * sizeof(value_type);
+    if (ftruncate(fd, static_cast<off_t>(length)) != 0) {
+        shm_unlink(name.c_str());
+        fail(fd, "ftruncate failed");
+    }
+    map(fd, true);
+
+    std::memcpy(header->magic, shared_ring_magic, sizeof(shared_ring_magic));
+    header->version = shared_ring_version;
+    header->element_size = sizeof(value_type);
+    header->capacity = cap;
+    header->data_offset = shared_ring_data_offset;
+    ::new (static_cast<void *>(&header->head)) std::atomic<std::uint64_t>(0);
+    ::new (static_cast<void *>(&header->tail)) std::atomic<std::uint64_t>(0);
+    ::new (static_cast<void *>(&header->ready)) std::atomic<std::uint32_t>(0);
+    header->ready.store(1, std::memory_order_release);
+}
+
+// Attaches to a segment created by another process
+SharedSpscCircularBuffer::SharedSpscCircularBuffer(const std::string &name)
+    : header(nullptr), slots(nullptr), length(0), cap(0), segment(name), owner(false), cached_head(0),
+      cached_tail(0) {
+    int fd = shm_open(name.c_str(), O_RDWR | O_CLOEXEC, 0);
+    if (fd < 0) {
+        fail(-1, "shm_open failed");
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        fail(fd, "fstat failed");
+    }
+    if (st.st_size < static_cast<off_t>(shared_ring_data_offset)) {
+        close(fd);
+        throw std::runtime_error("Shared ring is not initialized");
+    }
+    length = static_cast<std::size_t>(st.st_size);
+    map(fd, false);
+
+    // Unmaps the segment if a check below throws
+    struct Guard {
+        SharedSpscCircularBuffer *self;
+        ~Guard() {
+            if (self) {
+                munmap(self->header, self->length);
+            }
+        }
+    } guard{this};
+    if (header->ready.load(std::memory_order_acquire) != 1) {
+        throw std::runtime_error("Shared ring is not initialized");
+    }
+    if (std::memcmp(header->magic, shared_ring_magic, sizeof(shared_ring_magic)) != 0 ||
+        header->version != shared_ring_version) {
+        throw std::runtime_error("Not a shared ring");
+    }
+    if (header->element_size != sizeof(value_type) || header->data_offset != shared_ring_data_offset ||
+        header->capacity > static_cast<std::uint64_t>(INT_MAX) ||
+        length < header->data_offset + header->capacity * sizeof(value_type)) {
+        throw std::runtime_error("Shared ring has an incompatible layout");
+    }
+    guard.self = nullptr;
+    cap = static_cast<std::size_t>(header->capacity);
+    cached_head = header->head.load(std::memory_order_acquire);
+    cached_tail = header->tail.load(std::memory_order_acquire);
+}
+
+// Maps length bytes of the open segment fd
+void SharedSpscCircularBuffer::map(int fd, bool create) {
+    void *mapped = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapped == MAP_FAILED) {
+        if (create) {
+            shm_unlink(segment.c_str());
+        }
+        fail(fd, "mmap of the shared ring failed");
+    }
+    // The mapping keeps the segment alive
+    close(fd);
+    header = static_cast<SharedRingHeader *>(mapped);
+    slots = reinterpret_cast<value_type *>(static_cast<unsigned char *>(mapped) + shared_ring_data_offset);
+}
+
+// Destructor
+SharedSpscCircularBuffer::~SharedSpscCircularBuffer() {
+    munmap(header, length);
+    if (owner) {
+        shm_unlink(segment.c_str());
+    }
+}
+
+// Removes a segment name left behind by a crashed creator
+void SharedSpscCircularBuffer::unlink(const std::string &name) {
+    shm_unlink(name.c_str());
+}
+
+#else
+
+// Creates a segment with the given name and capacity, replacing a stale one
+// The name must start with a slash, as required by shm_open
+SharedSpscCircularBuffer::SharedSpscCircularBuffer(const std::string &name, int capacity)
+    : header(nullptr), slots(nullptr), length(0), cap(0), segment(name), owner(false), cached_head(0),
+      cached_tail(0) {
+    (void)capacity;
+    throw std::runtime_error("Shared rings are only supported on Linux");
+}
+
+// Attaches to a segment created by another process
+SharedSpscCircularBuffer::SharedSpscCircularBuffer(const std::string &name)
+    : header(nullptr), slots(nullptr), length(0), cap(0), segment(name), owner(false), cached_head(0),
+      cached_tail(0) {
+    throw std::runtime_error("Shared rings are only supported on Linux");
+}
+
+// Maps length bytes of the open segment fd
+void SharedSpscCircularBuffer::map(int fd, bool create) {
+    (void)fd;
+    (void)create;
+}
+
+// Destructor
+SharedSpscCircularBuffer::~SharedSpscCircularBuffer() {}
+
+// Removes a segment name left behind by a crashed creator
+void SharedSpscCircularBuffer::unlink(const std::string &name) {
+    (void)name;
+}
+
+#endif
+
+// Producer: adds an element to the end of the ring
+// Returns false if the ring is full
+bool SharedSpscCircularBuffer::try_push(const value_type &item) {
+    return try_push(&item, 1) == 1;
+}
+
+// Producer: adds up to n elements from data to the end of the ring
+// Returns the number of elements added; the consumer sees them all at once
+int SharedSpscCircularBuffer::try_push(const value_type *data, int n) {
+    if (n < 0) {
+        throw std::invalid_argument("n must be non-negative");
+    }
+    std::uint64_t t = header->tail.load(std::memory_order_relaxed);
+    std::size_t free = cap - static_cast<std::size_t>(t - cached_head);
+    if (free < static_cast<std::size_t>(n)) {
+        cached_head = header->head.load(std::memory_order_acquire);
+        free = cap - static_cast<std::size_t>(t - cached_head);
+    }
+    std::size_t k = free < static_cast<std::size_t>(n) ? free : static_cast<std::size_t>(n);
+    if (k == 0) {
+        return 0;
+    }
+    std::size_t slot = static_cast<std::size_t>(t % cap);
+    std::size_t first = k < cap - slot ? k : cap - slot;
+    std::memcpy(slots + slot, data, first * sizeof(value_type));
+    std::memcpy(slots, data + first, (k - first) * sizeof(value_type));
+    header->tail.store(t + k, std::memory_order_release);
+    return static_cast<int>(k);
+}
+
+// Consumer: removes the first element of the ring into item
+// Returns false if the ring is empty
+bool SharedSpscCircularBuffer::try_pop(value_type &item) {
+    return try_pop(&item, 1) == 1;
+}
+
+// Consumer: removes up to n elements from the front of the ring into out
+// Returns the number of elements removed
+int SharedSpscCircularBuffer::try_pop(value_type *out, int n) {
+    if (n < 0) {
+        throw std::invalid_argument("n must be non-negative");
+    }
+    std::uint64_t h = header->head.load(std::memory_order_relaxed);
+    std::size_t ready = static_cast<std::size_t>(cached_tail - h);
+    if (ready < static_cast<std::size_t>(n)) {
+        cached_tail = header->tail.load(std::memory_order_acquire);
+        ready = static_cast<std::size_t>(cached_tail - h);
+    }
+    std::size_t k = ready < static_cast<std::size_t>(n) ? ready : static_cast<std::size_t>(n);
+    if (k == 0) {
+        return 0;
+    }
+    std::size_t slot = static_cast<std::size_t>(h % cap);
+    std::size_t first = k < cap - slot ? k : cap - slot;
+    std::memcpy(out, slots + slot, first * sizeof(value_type));
+    std::memcpy(out + first, slots, (k - first) * sizeof(value_type));
+    header->head.store(h + k, std::memory_order_release);
+    return static_cast<int>(k);
+}
+
+// Returns the number of stored elements; exact only when both sides are idle
+int SharedSpscCircularBuffer::size() const {
+    std::uint64_t h = header->head.load(std::memory_order_acquire);
+    std::uint64_t t = header->tail.load(std::memory_order_acquire);
+    return t > h ? static_cast<int>(t - h) : 0;
+}
+
+// Checks if the ring is empty
+bool SharedSpscCircularBuffer::empty() const {
+    return size() == 0;
+}
+
+// Returns the capacity of the ring
+int SharedSpscCircularBuffer::capacity() const {
+    return static_cast<int>(cap);
+}
+
+// Returns the name of the segment
+const std::string &SharedSpscCircularBuffer::name() const {
+    return segment;
+}
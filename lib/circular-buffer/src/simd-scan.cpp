@@ -0,0 +1,259 @@
+#include "simd-scan.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define CIRCULAR_BUFFER_X86 1
+#endif
+
+namespace {
+
+// One implementation of every kernel
+struct ScanKernels {
+    ScanLevel level;
+    const char* (*find)(const char*, const char*, char);
+    std::size_t (*count)(const char*, const char*, char);
+    const char* (*search)(const char*, const char*, const char*, std::size_t);
+};
+
+const char* find_scalar(const char* first, const char* last, char value) {
+    const void* hit = std::memchr(first, value, static_cast<std::size_t>(last - first));
+    return hit ? static_cast<const char*>(hit) : last;
+}
+
+std::size_t count_scalar(const char* first, const char* last, char value) {
+    std::size_t n = 0;
+    for (; first != last; ++first) {
+        n += *first == value;
+    }
+    return n;
+}
+
+// Looks for the first byte of the needle and verifies the rest
+const char* search_scalar(const char* first, const char* last, const char* needle, std::size_t n) {
+    if (n == 0) {
+        return first;
+    }
+    if (static_cast<std::size_t>(last - first) < n) {
+        return last;
+    }
+    const char* stop = last - n + 1;
+    for (const char* p = first; (p = find_scalar(p, stop, needle[0])) != stop; ++p) {
+        if (std::memcmp(p + 1, needle + 1, n - 1) == 0) {
+            return p;
+        }
+    }
+    return last;
+}
+
+#ifdef CIRCULAR_BUFFER_X86
+
+__attribute__((target("sse2")))
+const char* find_sse2(const char* first, const char* last, char value) {
+    const __m128i v = _mm_set1_epi8(value);
+    for (; last - first >= 16; first += 16) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, v)));
+        if (mask) {
+            return first + __builtin_ctz(mask);
+        }
+    }
+    for (; first != last; ++first) {
+        if (*first == value) {
+            return first;
+        }
+    }
+    return last;
+}
+
+// Matches subtract -1 from per-byte counters, which are flushed into
+// 64-bit sums with psadbw before they can overflow
+__attribute__((target("sse2")))
+std::size_t count_sse2(const char* first, const char* last, char value) {
+    const __m128i v = _mm_set1_epi8(value);
+    const __m128i zero = _mm_setzero_si128();
+    __m128i sums = zero;
+    while (last - first >= 16) {
+        __m128i bytes = zero;
+        for (int i = 0; i < 255 && last - first >= 16; ++i, first += 16) {
+            __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+            bytes = _mm_sub_epi8(bytes, _mm_cmpeq_epi8(block, v));
+        }
+        sums = _mm_add_epi64(sums, _mm_sad_epu8(bytes, zero));
+    }
+    std::uint64_t lanes[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), sums);
+    return static_cast<std::size_t>(lanes[0] + lanes[1]) + count_scalar(first, last, value);
+}
+
+// Compares 16 candidate starts at once against the first and the last byte
+// of the needle and verifies only the starts where both match
+__attribute__((target("sse2")))
+const char* search_sse2(const char* first, const char* last, const char* needle, std::size_t n) {
+    if (n < 2) {
+        return n == 0 ? first : find_sse2(first, last, needle[0]);
+    }
+    if (static_cast<std::size_t>(last - first) < n) {
+        return last;
+    }
+    const __m128i head = _mm_set1_epi8(needle[0]);
+    const __m128i tail = _mm_set1_epi8(needle[n - 1]);
+    const char* stop = last - n + 1;
+    const char* p = first;
+    for (; stop - p >= 16; p += 16) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + n - 1));
+        unsigned mask = static_cast<unsigned>(
+            _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(a, head), _mm_cmpeq_epi8(b, tail))));
+        while (mask) {
+            const char* candidate = p + __builtin_ctz(mask);
+            if (std::memcmp(candidate + 1, needle + 1, n - 2) == 0) {
+                return candidate;
+            }
+            mask &= mask - 1;
+        }
+    }
+    return search_scalar(p, last, needle, n);
+}
+
+__attribute__((target("avx2")))
+const char* find_avx2(const char* first, const char* last, char value) {
+    const __m256i v = _mm256_set1_epi8(value);
+    // Two blocks per step, tested together
+    for (; last - first >= 64; first += 64) {
+        __m256i a = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(first)), v);
+        __m256i b = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(first + 32)), v);
+        if (!_mm256_testz_si256(_mm256_or_si256(a, b), _mm256_or_si256(a, b))) {
+            unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(a));
+            if (mask) {
+                return first + __builtin_ctz(mask);
+            }
+            return first + 32 + __builtin_ctz(static_cast<unsigned>(_mm256_movemask_epi8(b)));
+        }
+    }
+    if (last - first >= 32) {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, v)));
+        if (mask) {
+            return first + __builtin_ctz(mask);
+        }
+        first += 32;
+    }
+    return find_sse2(first, last, value);
+}
+
+__attribute__((target("avx2")))
+std::size_t count_avx2(const char* first, const char* last, char value) {
+    const __m256i v = _mm256_set1_epi8(value);
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i sums = zero;
+    while (last - first >= 32) {
+        __m256i bytes = zero;
+        for (int i = 0; i < 255 && last - first >= 32; ++i, first += 32) {
+            __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+            bytes = _mm256_sub_epi8(bytes, _mm256_cmpeq_epi8(block, v));
+        }
+        sums = _mm256_add_epi64(sums, _mm256_sad_epu8(bytes, zero));
+    }
+    std::uint64_t lanes[4];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), sums);
+    return static_cast<std::size_t>(lanes[0] + lanes[1] + lanes[2] + lanes[3]) + count_sse2(first, last, value);
+}
+
+__attribute__((target("avx2")))
+const char* search_avx2(const char* first, const char* last, const char* needle, std::size_t n) {
+    if (n < 2) {
+        return n == 0 ? first : find_avx2(first, last, needle[0]);
+    }
+    if (static_cast<std::size_t>(last - first) < n) {
+        return last;
+    }
+    const __m256i head = _mm256_set1_epi8(needle[0]);
+    const __m256i tail = _mm256_set1_epi8(needle[n - 1]);
+    const char* stop = last - n + 1;
+    const char* p = first;
+    for (; stop - p >= 32; p += 32) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + n - 1));
+        unsigned mask = static_cast<unsigned>(
+            _mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(a, head), _mm256_cmpeq_epi8(b, tail))));
+        while (mask) {
+            const char* candidate = p + __builtin_ctz(mask);
+            if (std::memcmp(candidate + 1, needle + 1, n - 2) == 0) {
+                return candidate;
+            }
+            mask &= mask - 1;
+        }
+    }
+    return search_sse2(p, last, needle, n);
+}
+
+#endif
+
+const ScanKernels scalar_kernels = {ScanLevel::Scalar, find_scalar, count_scalar, search_scalar};
+#ifdef CIRCULAR_BUFFER_X86
+const ScanKernels sse2_kernels = {ScanLevel::Sse2, find_sse2, count_sse2, search_sse2};
+const ScanKernels avx2_kernels = {ScanLevel::Avx2, find_avx2, count_avx2, search_avx2};
+#endif
+
+// Returns the kernels of the highest level up to limit that the CPU supports
+const ScanKernels* select_kernels(ScanLevel limit) {
+#ifdef CIRCULAR_BUFFER_X86
+    __builtin_cpu_init();
+    if (limit >= ScanLevel::Avx2 && __builtin_cpu_supports("avx2")) {
+        return &avx2_kernels;
+    }
+    if (limit >= ScanLevel::Sse2 && __builtin_cpu_supports("sse2")) {
+        return &sse2_kernels;
+    }
+#else
+    (void)limit;
+#endif
+    return &scalar_kernels;
+}
+
+// Kernels in use, selected on first use
+std::atomic<const ScanKernels*> active_kernels(nullptr);
+
+const ScanKernels& kernels() {
+    const ScanKernels* k = active_kernels.load(std::memory_order_relaxed);
+    if (!k) {
+        k = select_kernels(ScanLevel::Avx2);
+        active_kernels.store(k, std::memory_order_relaxed);
+    }
+    return *k;
+}
+
+}  // namespace
+
+// Returns the instruction set the kernels currently use
+ScanLevel scan_level() {
+    return kernels().level;
+}
+
+// Makes the kernels use at most the given instruction set, for tests and benchmarks
+// Returns the instruction set actually in effect, which the CPU may cap
+ScanLevel set_scan_level(ScanLevel level) {
+    const ScanKernels* k = select_kernels(level);
+    active_kernels.store(k, std::memory_order_relaxed);
+    return k->level;
+}
+
+// Returns the first byte equal to value in [first, last), or last
+const char* scan_find(const char* first, const char* last, char value) {
+    return kernels().find(first, last, value);
+}
+
+// Returns the number of bytes equal to value in [first, last)
+std::size_t scan_count(const char* first, const char* last, char value) {
+    return kernels().count(first, last, value);
+}
+
+// Returns the start of the first occurrence of needle[0, n) lying entirely in [first, last),
+// or last; an empty needle matches at first
+const char* scan_search(const char* first, const char* last, const char* needle, std::size_t n) {
+    return kernels().search(first, last, needle, n);
+}
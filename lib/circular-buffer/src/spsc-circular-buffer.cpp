@@ -0,0 +1,110 @@
+#include "spsc-circular-buffer.h"
+
+// Constructs a ring with a given capacity and overflow behaviour
+SpscCircularBuffer::SpscCircularBuffer(int capacity, OverflowMode mode)
+    : buffer(nullptr), slots(nullptr), cap(0), mode(mode), head(0), cached_tail(0), tail(0), cached_head(0) {
+    if (capacity < 0) {
+        throw std::invalid_argument("Capacity must be non-negative");
+    }
+    cap = static_cast<std::size_t>(capacity);
+    if (mode == OverflowMode::Overwrite) {
+        slots = new std::atomic<value_type>[cap];
+    } else {
+        buffer = new value_type[cap];
+    }
+}
+
+// Destructor
+SpscCircularBuffer::~SpscCircularBuffer() {
+    delete[] buffer;
+    delete[] slots;
+}
+
+// Producer: adds an element to the end of the ring
+// Returns false if the ring is full in Reject mode or has zero capacity
+bool SpscCircularBuffer::try_push(const value_type &item) {
+    std::size_t t = tail.load(std::memory_order_relaxed);
+    if (t - cached_head == cap) {
+        cached_head = head.load(std::memory_order_acquire);
+        if (t - cached_head == cap) {
+            if (mode == OverflowMode::Reject || cap == 0) {
+                return false;
+            }
+            // Drop the oldest element. If the CAS fails the consumer has
+            // just taken it, which frees the slot just as well.
+            std::size_t h = cached_head;
+            if (head.compare_exchange_strong(h, h + 1, std::memory_order_acq_rel,
+                                             std::memory_order_acquire)) {
+                ++h;
+            }
+            cached_head = h;
+        }
+    }
+    if (mode == OverflowMode::Overwrite) {
+        slots[t % cap].store(item, std::memory_order_relaxed);
+    } else {
+        buffer[t % cap] = item;
+    }
+    tail.store(t + 1, std::memory_order_release);
+    return true;
+}
+
+// Consumer: removes the first element of the ring into item
+// Returns false if the ring is empty
+bool SpscCircularBuffer::try_pop(value_type &item) {
+    if (mode == OverflowMode::Overwrite) {
+        return try_pop_overwrite(item);
+    }
+    std::size_t h = head.load(std::memory_order_relaxed);
+    if (h == cached_tail) {
+        cached_tail = tail.load(std::memory_order_acquire);
+        if (h == cached_tail) {
+            return false;
+        }
+    }
+    item = buffer[h % cap];
+    head.store(h + 1, std::memory_order_release);
+    return true;
+}
+
+// In Overwrite mode the producer may advance head as well, so the consumer
+// copies the slot first and then claims it with a CAS. A failed CAS means
+// the slot was recycled by the producer and the copy is discarded. A
+// successful CAS happens before the producer's next store to the slot, so
+// relaxed slot accesses suffice.
+bool SpscCircularBuffer::try_pop_overwrite(value_type &item) {
+    std::size_t h = head.load(std::memory_order_acquire);
+    for (;;) {
+        if (h == tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        value_type value = slots[h % cap].load(std::memory_order_relaxed);
+        if (head.compare_exchange_weak(h, h + 1, std::memory_order_acq_rel,
+                                       std::memory_order_acquire)) {
+            item = value;
+            return true;
+        }
+    }
+}
+
+// Returns the number of stored elements; exact only when both sides are idle
+int SpscCircularBuffer::size() const {
+    std::size_t h = head.load(std::memory_order_acquire);
+    std::size_t t = tail.load(std::memory_order_acquire);
+    return t > h ? static_cast<int>(t - h) : 0;
+}
+
+// Checks if the ring is empty
+bool SpscCircularBuffer::empty() const {
+    return size() == 0;
+}
+
+// Returns the capacity of the ring
+int SpscCircularBuffer::capacity() const {
+    return static_cast<int>(cap);
+}
+
+// Returns the overflow behaviour selected at construction
+OverflowMode SpscCircularBuffer::overflow_mode() const {
+    return mode;
+}
@@ -0,0 +1,85 @@
+#include "wait-word.h"
+
+#include <algorithm>
+#include <climits>
+#include <thread>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+// Constructs a word with value zero
+WaitWord::WaitWord() : word(0) {}
+
+// Returns the current value
+std::uint32_t WaitWord::load() const {
+    return word.load(std::memory_order_acquire);
+}
+
+#ifdef __linux__
+
+// Blocks in the kernel while word equals expected; timeout may be null
+static void futex_wait(std::atomic<std::uint32_t>& word, std::uint32_t expected, const timespec* timeout) {
+    syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAIT_PRIVATE, expected, timeout,
+            nullptr, 0);
+}
+
+// Sleeps while the value equals expected; may return spuriously
+void WaitWord::wait(std::uint32_t expected) {
+    futex_wait(word, expected, nullptr);
+}
+
+// Sleeps while the value equals expected, at most until deadline
+// Returns false if the deadline has passed; may return true spuriously
+bool WaitWord::wait_until(std::uint32_t expected, std::chrono::steady_clock::time_point deadline) {
+    auto left = deadline - std::chrono::steady_clock::now();
+    if (left <= std::chrono::steady_clock::duration::zero()) {
+        return false;
+    }
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(left).count();
+    timespec timeout;
+    timeout.tv_sec = static_cast<time_t>(ns / 1000000000);
+    timeout.tv_nsec = static_cast<long>(ns % 1000000000);
+    futex_wait(word, expected, &timeout);
+    return true;
+}
+
+// Changes the value and wakes up to n sleeping threads, all of them if n is negative
+void WaitWord::notify(int n) {
+    word.fetch_add(1, std::memory_order_release);
+    syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAKE_PRIVATE, n < 0 ? INT_MAX : n,
+            nullptr, nullptr, 0);
+}
+
+#else
+
+// Sleeps while the value equals expected; may return spuriously
+void WaitWord::wait(std::uint32_t expected) {
+    if (word.load(std::memory_order_acquire) == expected) {
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+}
+
+// Sleeps while the value equals expected, at most until deadline
+// Returns false if the deadline has passed; may return true spuriously
+bool WaitWord::wait_until(std::uint32_t expected, std::chrono::steady_clock::time_point deadline) {
+    auto now = std::chrono::steady_clock::now();
+    if (now >= deadline) {
+        return false;
+    }
+    if (word.load(std::memory_order_acquire) == expected) {
+        std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(
+            deadline - now, std::chrono::microseconds(50)));
+    }
+    return true;
+}
+
+// Changes the value and wakes up to n sleeping threads, all of them if n is negative
+void WaitWord::notify(int) {
+    word.fetch_add(1, std::memory_order_release);
+}
+
+#endif
@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "blocking-circular-buffer.h"
+#include "mpmc-circular-buffer.h"
+#include "spsc-circular-buffer.h"
+
+// Неблокирующие операции ведут себя как у исходной очереди
+TEST(BlockingCircularBufferTest, TryOperations) {
+    BlockingCircularBuffer<SpscCircularBuffer> q(2);
+    EXPECT_EQ(q.capacity(), 2);
+    EXPECT_TRUE(q.try_push('a'));
+    EXPECT_TRUE(q.try_push('b'));
+    EXPECT_FALSE(q.try_push('c'));
+    EXPECT_EQ(q.size(), 2);
+
+    char item;
+    EXPECT_TRUE(q.try_pop(item));
+    EXPECT_EQ(item, 'a');
+    EXPECT_TRUE(q.try_pop(item));
+    EXPECT_EQ(item, 'b');
+    EXPECT_FALSE(q.try_pop(item));
+    EXPECT_TRUE(q.empty());
+}
+
+// Ожидание с таймаутом завершается неудачей на пустой и полной очереди
+TEST(BlockingCircularBufferTest, TimedWaitsExpire) {
+    BlockingCircularBuffer<MpmcCircularBuffer<int>> q(2);
+    int item = 0;
+    auto begin = std::chrono::steady_clock::now();
+    EXPECT_FALSE(q.pop_wait_for(item, std::chrono::milliseconds(20)));
+    EXPECT_GE(std::chrono::steady_clock::now() - begin, std::chrono::milliseconds(20));
+
+    EXPECT_TRUE(q.push_wait_for(1, std::chrono::milliseconds(20)));
+    EXPECT_TRUE(q.push_wait_for(3, std::chrono::milliseconds(20)));
+    EXPECT_FALSE(q.push_wait_until(2, std::chrono::steady_clock::now() + std::chrono::milliseconds(5)));
+    EXPECT_TRUE(q.pop_wait_until(item, std::chrono::steady_clock::now()));
+    EXPECT_EQ(item, 1);
+}
+
+// Спящий потребитель просыпается, когда производитель кладёт элемент
+TEST(BlockingCircularBufferTest, PopWaitWakesUp) {
+    BlockingCircularBuffer<SpscCircularBuffer> q(4);
+    char item = 0;
+    std::thread consumer([&q, &item] { q.pop_wait(item); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    q.push_wait('x');
+    consumer.join();
+    EXPECT_EQ(item, 'x');
+}
+
+// Производитель ждёт освобождения места в полной очереди
+TEST(BlockingCircularBufferTest, PushWaitWakesUp) {
+    BlockingCircularBuffer<MpmcCircularBuffer<int>> q(2);
+    q.push_wait(1);
+    q.push_wait(1);
+    std::atomic<bool> pushed(false);
+    std::thread producer([&q, &pushed] {
+        q.push_wait(2);
+        pushed = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_FALSE(pushed.load());
+    int item;
+    q.pop_wait(item);
+    EXPECT_EQ(item, 1);
+    producer.join();
+    EXPECT_TRUE(pushed.load());
+    q.pop_wait(item);
+    q.pop_wait(item);
+    EXPECT_EQ(item, 2);
+}
+
+// Нагрузочный тест: маленькая очередь, несколько производителей и потребителей, никто не теряет пробуждение
+TEST(BlockingCircularBufferTest, StressManyProducersManyConsumers) {
+    const int producers = 3;
+    const int consumers = 3;
+    const int per_producer = 20000;
+    BlockingCircularBuffer<MpmcCircularBuffer<int>> q(4);
+    std::atomic<long long> sum(0);
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&q, per_producer] {
+            for (int i = 1; i <= per_producer; ++i) {
+                q.push_wait(i);
+            }
+        });
+    }
+    for (int c = 0; c < consumers; ++c) {
+        threads.emplace_back([&q, &sum, producers, consumers, per_producer] {
+            for (int i = 0; i < producers * per_producer / consumers; ++i) {
+                int item;
+                q.pop_wait(item);
+                sum += item;
+            }
+        });
+    }
+    for (std::thread& t : threads) {
+        t.join();
+    }
+    EXPECT_EQ(sum.load(), static_cast<long long>(producers) * per_producer * (per_producer + 1) / 2);
+    EXPECT_TRUE(q.empty());
+}
@@ -1,5 +1,17 @@
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <vector>
+#include <sys/uio.h>
+#include <unistd.h>
+#include "aligned-allocator.h"
 #include "circular-buffer.h"
+#include "masked-circular-buffer.h"
 
 // Тестирование конструктора по умолчанию
 TEST(CircularBufferTest, DefaultConstructor) {
@@ -157,7 +169,7 @@ TEST(CircularBufferTest, Linearize) {
 
     EXPECT_FALSE(cb.is_linearized());
 
-    value_type* data = cb.linearize();
+    CircularBuffer<>::value_type* data = cb.linearize();
     EXPECT_TRUE(cb.is_linearized());
     EXPECT_EQ(data[0], 'b');
     EXPECT_EQ(data[1], 'c');
@@ -370,6 +382,800 @@ TEST(CircularBufferTest, OverwriteBehavior) {
     EXPECT_EQ(cb[2], 'c');
 }
 
+// Тестирование пакетных push_back и pop_front с переходом через конец массива
+TEST(CircularBufferTest, BulkPushBackPopFront) {
+    CircularBuffer cb(5);
+    cb.push_back("abc", 3);
+    char out[5];
+    cb.pop_front(out, 2);
+    EXPECT_EQ(out[0], 'a');
+    EXPECT_EQ(out[1], 'b');
+
+    cb.push_back("defg", 4); // Запись переходит через конец массива
+    EXPECT_EQ(cb.size(), 5);
+    EXPECT_FALSE(cb.is_linearized());
+    cb.pop_front(out, 5);
+    EXPECT_EQ(std::string(out, 5), "cdefg");
+    EXPECT_TRUE(cb.empty());
+
+    EXPECT_THROW(cb.pop_front(out, 1), std::runtime_error);
+    EXPECT_THROW(cb.push_back("a", -1), std::invalid_argument);
+}
+
+// Пакетные операции при переполнении ведут себя как поэлементные
+TEST(CircularBufferTest, BulkOverwriteMatchesSingle) {
+    const char data[] = "0123456789";
+    for (int n = 0; n <= 10; ++n) {
+        CircularBuffer bulk(4);
+        CircularBuffer single(4);
+        bulk.push_back("xyz", 3);
+        single.push_back("xyz", 3);
+        bulk.pop_front();
+        single.pop_front();
+
+        bulk.push_back(data, n);
+        for (int i = 0; i < n; ++i) {
+            single.push_back(data[i]);
+        }
+        EXPECT_TRUE(bulk == single);
+
+        bulk.push_front(data, n);
+        for (int i = n - 1; i >= 0; --i) {
+            single.push_front(data[i]);
+        }
+        EXPECT_TRUE(bulk == single);
+    }
+}
+
+// Тестирование пакетных push_front и pop_back
+TEST(CircularBufferTest, BulkPushFrontPopBack) {
+    CircularBuffer cb(5);
+    cb.push_back('z');
+    cb.push_front("abc", 3);
+    EXPECT_EQ(cb.size(), 4);
+    EXPECT_EQ(cb[0], 'a');
+    EXPECT_EQ(cb[1], 'b');
+    EXPECT_EQ(cb[2], 'c');
+    EXPECT_EQ(cb[3], 'z');
+
+    char out[3];
+    cb.pop_back(out, 3);
+    EXPECT_EQ(std::string(out, 3), "bcz");
+    EXPECT_EQ(cb.size(), 1);
+    EXPECT_EQ(cb.front(), 'a');
+    EXPECT_THROW(cb.pop_back(out, 2), std::runtime_error);
+
+    CircularBuffer empty;
+    EXPECT_THROW(empty.push_front("a", 1), std::runtime_error);
+}
+
+// Тестирование округления ёмкости до степени двойки
+TEST(MaskedCircularBufferTest, CapacityRoundedUp) {
+    EXPECT_EQ(MaskedCircularBuffer(0).capacity(), 0);
+    EXPECT_EQ(MaskedCircularBuffer(1).capacity(), 1);
+    EXPECT_EQ(MaskedCircularBuffer(3).capacity(), 4);
+    EXPECT_EQ(MaskedCircularBuffer(1000).capacity(), 1024);
+    EXPECT_EQ(MaskedCircularBuffer(1024).capacity(), 1024);
+    EXPECT_THROW(MaskedCircularBuffer cb(-1), std::invalid_argument);
+    EXPECT_THROW(MaskedCircularBuffer().push_back('a'), std::runtime_error);
+}
+
+// Поведение MaskedCircularBuffer совпадает с CircularBuffer той же ёмкости
+TEST(MaskedCircularBufferTest, MatchesCircularBuffer) {
+    MaskedCircularBuffer masked(4);
+    CircularBuffer plain(4);
+    for (int step = 0; step < 100; ++step) {
+        char c = static_cast<char>('a' + step % 26);
+        switch (step % 5) {
+            case 0:
+            case 1:
+                masked.push_back(c);
+                plain.push_back(c);
+                break;
+            case 2:
+                masked.push_front(c);
+                plain.push_front(c);
+                break;
+            case 3:
+                masked.pop_front();
+                plain.pop_front();
+                break;
+            default:
+                if (!plain.empty()) {
+                    masked.pop_back();
+                    plain.pop_back();
+                }
+        }
+        ASSERT_EQ(masked.size(), plain.size());
+        ASSERT_EQ(masked.full(), plain.full());
+        for (int i = 0; i < plain.size(); ++i) {
+            ASSERT_EQ(masked[i], plain[i]);
+        }
+    }
+    MaskedCircularBuffer copy(masked);
+    EXPECT_EQ(copy.back(), plain.back());
+    EXPECT_EQ(copy.front(), plain.front());
+    copy.clear();
+    EXPECT_TRUE(copy.empty());
+    EXPECT_THROW(copy.pop_front(), std::runtime_error);
+    EXPECT_THROW(copy.at(0), std::out_of_range);
+}
+
+// Тип, подсчитывающий живые экземпляры
+struct Tracked {
+    static int alive;
+    int value;
+    Tracked(int v = 0) : value(v) { ++alive; }
+    Tracked(const Tracked& other) : value(other.value) { ++alive; }
+    Tracked& operator=(const Tracked& other) = default;
+    ~Tracked() { --alive; }
+    bool operator!=(const Tracked& other) const { return value != other.value; }
+};
+int Tracked::alive = 0;
+
+// Конструируются только хранимые элементы, а не вся ёмкость
+TEST(CircularBufferTemplateTest, ConstructsLiveElementsOnly) {
+    {
+        CircularBuffer<Tracked> cb(100);
+        EXPECT_EQ(Tracked::alive, 0);
+        cb.push_back(Tracked(1));
+        cb.push_back(Tracked(2));
+        cb.push_front(Tracked(0));
+        EXPECT_EQ(Tracked::alive, 3);
+        cb.insert(1, Tracked(5));
+        EXPECT_EQ(Tracked::alive, 4);
+        cb.erase(0, 2);
+        EXPECT_EQ(Tracked::alive, 2);
+        EXPECT_EQ(cb[0].value, 1);
+        EXPECT_EQ(cb[1].value, 2);
+
+        CircularBuffer<Tracked> copy(cb);
+        EXPECT_EQ(Tracked::alive, 4);
+        copy.set_capacity(1);
+        EXPECT_EQ(Tracked::alive, 3);
+        cb.resize(5, Tracked(7));
+        EXPECT_EQ(Tracked::alive, 6);
+        cb.pop_front();
+        cb.pop_back();
+        EXPECT_EQ(Tracked::alive, 4);
+    }
+    EXPECT_EQ(Tracked::alive, 0);
+}
+
+// Работа с нетривиальным типом при переполнении и линеаризации
+TEST(CircularBufferTemplateTest, StringElements) {
+    CircularBuffer<std::string> cb(3);
+    cb.push_back("one");
+    cb.push_back("two");
+    cb.push_back("three");
+    cb.push_back("four"); // "one" будет переписан
+    EXPECT_EQ(cb.front(), "two");
+    EXPECT_EQ(cb.back(), "four");
+    EXPECT_FALSE(cb.is_linearized());
+
+    std::string* data = cb.linearize();
+    EXPECT_EQ(data[0], "two");
+    EXPECT_EQ(data[1], "three");
+    EXPECT_EQ(data[2], "four");
+
+    cb.pop_back();
+    cb.rotate(1);
+    EXPECT_EQ(cb[0], "three");
+    EXPECT_EQ(cb[1], "two");
+
+    const std::string words[] = {"a", "b", "c", "d"};
+    cb.push_back(words, 4);
+    EXPECT_EQ(cb[0], "b");
+    EXPECT_EQ(cb[2], "d");
+    std::string out[2];
+    cb.pop_front(out, 2);
+    EXPECT_EQ(out[0], "b");
+    EXPECT_EQ(out[1], "c");
+    EXPECT_EQ(cb.size(), 1);
+}
+
+// Крупные записи фиксированного размера
+TEST(CircularBufferTemplateTest, LargeRecords) {
+    struct Record {
+        long long fields[8];
+    };
+    CircularBuffer<Record> cb(4);
+    for (int i = 0; i < 6; ++i) {
+        Record r = {};
+        r.fields[7] = i;
+        cb.push_back(r);
+    }
+    EXPECT_EQ(cb.size(), 4);
+    EXPECT_EQ(cb.front().fields[7], 2);
+    EXPECT_EQ(cb.back().fields[7], 5);
+}
+
+// Перемещающий конструктор и присваивание забирают хранилище без копирования
+TEST(CircularBufferMoveTest, MoveConstructAndAssign) {
+    CircularBuffer<std::string> cb(4);
+    cb.push_back("a");
+    cb.push_back("b");
+    const std::string* storage = &cb[0];
+
+    CircularBuffer<std::string> moved(std::move(cb));
+    EXPECT_EQ(&moved[0], storage);
+    EXPECT_EQ(moved.size(), 2);
+    EXPECT_EQ(moved.capacity(), 4);
+    EXPECT_EQ(cb.size(), 0);
+    EXPECT_EQ(cb.capacity(), 0);
+
+    CircularBuffer<std::string> assigned(1, "x");
+    assigned = std::move(moved);
+    EXPECT_EQ(&assigned[0], storage);
+    EXPECT_EQ(assigned.back(), "b");
+    EXPECT_TRUE(moved.empty());
+}
+
+// Буфер с перемещаемыми, но не копируемыми элементами
+TEST(CircularBufferMoveTest, MoveOnlyElements) {
+    CircularBuffer<std::unique_ptr<int>> cb(3);
+    cb.push_back(std::unique_ptr<int>(new int(1)));
+    cb.emplace_back(new int(2));
+    cb.emplace_front(new int(0));
+    EXPECT_EQ(*cb[0], 0);
+    EXPECT_EQ(*cb[1], 1);
+    EXPECT_EQ(*cb[2], 2);
+
+    // Переполнение: первый элемент перезаписывается
+    std::unique_ptr<int>& last = cb.emplace_back(new int(3));
+    EXPECT_EQ(*last, 3);
+    EXPECT_EQ(*cb.front(), 1);
+
+    cb.pop_back();
+    cb.emplace(1, new int(7));
+    cb.pop_front();
+    cb.insert(0, std::unique_ptr<int>(new int(9)));
+    EXPECT_EQ(*cb[0], 9);
+    EXPECT_EQ(*cb[1], 7);
+    EXPECT_EQ(*cb[2], 2);
+
+    cb.set_capacity(5);
+    cb.resize(5);
+    EXPECT_EQ(cb[4], nullptr);
+    cb.linearize();
+    cb.rotate(2);
+    EXPECT_EQ(*cb[0], 2);
+    EXPECT_EQ(*cb[3], 9);
+}
+
+// emplace конструирует элемент из аргументов конструктора
+TEST(CircularBufferMoveTest, EmplaceFromArguments) {
+    CircularBuffer<std::string> cb(3);
+    cb.emplace_back(3, 'a');
+    cb.emplace_front("bc");
+    cb.emplace(1, 2, 'z');
+    EXPECT_EQ(cb[0], "bc");
+    EXPECT_EQ(cb[1], "zz");
+    EXPECT_EQ(cb[2], "aaa");
+    EXPECT_THROW(cb.emplace(0, "full"), std::runtime_error);
+    EXPECT_THROW(cb.emplace(4, "bad"), std::out_of_range);
+}
+
+// Запись напрямую в свободное место и чтение напрямую из хранилища
+TEST(CircularBufferRegionsTest, WriteCommitReadConsume) {
+    CircularBuffer<char> cb(8);
+    cb.push_back("abcdef", 6);
+    cb.consume(4); // Свободное место теперь разорвано концом массива
+
+    auto free_space = cb.write_regions();
+    EXPECT_EQ(free_space[0].size, 2);
+    EXPECT_EQ(free_space[1].size, 4);
+    std::memcpy(free_space[0].data, "gh", 2);
+    std::memcpy(free_space[1].data, "ij", 2);
+    cb.commit_write(4);
+    EXPECT_EQ(cb.size(), 6);
+    EXPECT_EQ(cb[0], 'e');
+    EXPECT_EQ(cb[5], 'j');
+
+    auto data = cb.read_regions();
+    EXPECT_EQ(std::string(data[0].data, data[0].size), "efgh");
+    EXPECT_EQ(std::string(data[1].data, data[1].size), "ij");
+    cb.consume(5);
+    EXPECT_EQ(cb.front(), 'j');
+
+    EXPECT_THROW(cb.commit_write(8), std::out_of_range);
+    EXPECT_THROW(cb.consume(2), std::out_of_range);
+
+    // Пустой буфер отдаёт всё свободное место одним куском
+    cb.consume(1);
+    free_space = cb.write_regions();
+    EXPECT_EQ(free_space[0].size, 8);
+    EXPECT_EQ(free_space[1].size, 0);
+}
+
+// readv/writev напрямую в хранилище кольца и из него
+TEST(CircularBufferRegionsTest, ScatterGatherIo) {
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+    ASSERT_EQ(write(fds[1], "0123456789", 10), 10);
+
+    CircularBuffer<char> cb(12);
+    cb.push_back("xxxxxxx", 7);
+    cb.consume(7);
+    cb.push_back('<');
+
+    auto free_space = cb.write_regions();
+    iovec in[2] = {{free_space[0].data, static_cast<size_t>(free_space[0].size)},
+                   {free_space[1].data, static_cast<size_t>(free_space[1].size)}};
+    ssize_t got = readv(fds[0], in, 2);
+    ASSERT_EQ(got, 10);
+    cb.commit_write(static_cast<int>(got));
+    EXPECT_FALSE(cb.is_linearized());
+
+    auto data = cb.read_regions();
+    iovec out[2] = {{data[0].data, static_cast<size_t>(data[0].size)},
+                    {data[1].data, static_cast<size_t>(data[1].size)}};
+    ASSERT_EQ(writev(fds[1], out, 2), 11);
+    cb.consume(11);
+    EXPECT_TRUE(cb.empty());
+
+    char echoed[11];
+    ASSERT_EQ(read(fds[0], echoed, 11), 11);
+    EXPECT_EQ(std::string(echoed, 11), "<0123456789");
+    close(fds[0]);
+    close(fds[1]);
+}
+
+// Линеаризация на месте во всех раскладках: один сдвинутый сегмент, два сегмента, полный буфер
+TEST(CircularBufferLinearizeTest, InPlaceLayouts) {
+    for (int shift = 0; shift < 6; ++shift) {
+        for (int n = 1; n <= 6; ++n) {
+            CircularBuffer<std::string> cb(6);
+            CircularBuffer<char> bytes(6);
+            for (int i = 0; i < shift; ++i) {
+                cb.push_back("-");
+                bytes.push_back('-');
+            }
+            for (int i = 0; i < n; ++i) {
+                cb.push_back(std::string(1, static_cast<char>('a' + i)));
+                bytes.push_back(static_cast<char>('a' + i));
+            }
+            for (int i = 0; i < shift && cb.size() > n; ++i) {
+                cb.pop_front();
+                bytes.pop_front();
+            }
+            std::string* data = cb.linearize();
+            char* raw = bytes.linearize();
+            ASSERT_TRUE(cb.is_linearized());
+            ASSERT_EQ(cb.size(), n);
+            for (int i = 0; i < n; ++i) {
+                ASSERT_EQ(data[i], std::string(1, static_cast<char>('a' + i)));
+                ASSERT_EQ(raw[i], static_cast<char>('a' + i));
+            }
+            // После линеаризации буфер продолжает работать как кольцо
+            cb.push_back("z");
+            EXPECT_EQ(cb.back(), "z");
+        }
+    }
+}
+
+// Линеаризация и поворот не создают и не теряют элементов
+TEST(CircularBufferLinearizeTest, NoLeakedOrExtraElements) {
+    {
+        CircularBuffer<Tracked> cb(7);
+        for (int i = 0; i < 10; ++i) {
+            cb.push_back(Tracked(i));
+        }
+        cb.pop_front();
+        cb.pop_front();
+        cb.push_back(Tracked(10)); // Два сегмента с разрывом
+        EXPECT_EQ(Tracked::alive, 6);
+        cb.linearize();
+        EXPECT_EQ(Tracked::alive, 6);
+        EXPECT_EQ(cb[0].value, 5);
+        EXPECT_EQ(cb[5].value, 10);
+
+        cb.rotate(4);
+        EXPECT_EQ(Tracked::alive, 6);
+        EXPECT_EQ(cb[0].value, 9);
+        EXPECT_EQ(cb[2].value, 5);
+        cb.rotate(1);
+        EXPECT_EQ(cb[0].value, 10);
+        EXPECT_EQ(cb[5].value, 9);
+    }
+    EXPECT_EQ(Tracked::alive, 0);
+}
+
+// Поворот и линеаризация больших байтовых буферов сверяются с std::rotate
+TEST(CircularBufferLinearizeTest, LargeByteRotations) {
+    const int cap = 5000;
+    const int sizes[] = {cap, cap - 1, 3000};
+    const int begins[] = {1, 700, 1500, 2999};
+    for (int n : sizes) {
+        for (int new_begin : begins) {
+            CircularBuffer<char> cb(cap);
+            std::vector<char> expected;
+            for (int i = 0; i < cap + 1234; ++i) {
+                cb.push_back(static_cast<char>(i * 7));
+            }
+            while (cb.size() > n) {
+                cb.pop_front();
+            }
+            for (int i = 0; i < cb.size(); ++i) {
+                expected.push_back(cb[i]);
+            }
+            cb.rotate(new_begin);
+            std::rotate(expected.begin(), expected.begin() + new_begin, expected.end());
+            char* data = cb.linearize();
+            ASSERT_EQ(std::string(data, cb.size()), std::string(expected.begin(), expected.end()));
+        }
+    }
+}
+
+// Итераторы произвольного доступа и алгоритмы STL на буфере с переходом через конец массива
+TEST(CircularBufferIteratorTest, StlAlgorithms) {
+    CircularBuffer<int> cb(6);
+    for (int i = 0; i < 9; ++i) {
+        cb.push_back(i);
+    }
+    ASSERT_FALSE(cb.is_linearized());
+
+    std::vector<int> seen;
+    for (int v : cb) {
+        seen.push_back(v);
+    }
+    EXPECT_EQ(seen, (std::vector<int>{3, 4, 5, 6, 7, 8}));
+
+    EXPECT_EQ(cb.end() - cb.begin(), 6);
+    EXPECT_EQ(cb.begin()[4], 7);
+    EXPECT_EQ(*(cb.end() - 1), 8);
+    EXPECT_EQ(*std::find(cb.begin(), cb.end(), 6), 6);
+    EXPECT_EQ(std::find(cb.begin(), cb.end(), 42), cb.end());
+
+    const int pattern[] = {5, 6, 7};
+    EXPECT_EQ(std::search(cb.begin(), cb.end(), pattern, pattern + 3) - cb.begin(), 2);
+
+    std::vector<int> reversed(cb.rbegin(), cb.rend());
+    EXPECT_EQ(reversed, (std::vector<int>{8, 7, 6, 5, 4, 3}));
+
+    std::sort(cb.begin(), cb.end(), [](int a, int b) { return a > b; });
+    EXPECT_EQ(cb.front(), 8);
+    EXPECT_EQ(cb.back(), 3);
+
+    const CircularBuffer<int>& ref = cb;
+    CircularBuffer<int>::const_iterator it = cb.begin();
+    EXPECT_TRUE(it == ref.cbegin());
+    EXPECT_TRUE(it < ref.cend());
+    EXPECT_EQ(std::distance(ref.crbegin(), ref.crend()), 6);
+}
+
+// Сегментные алгоритмы работают на двух непрерывных кусках хранилища
+TEST(CircularBufferIteratorTest, SegmentedAlgorithms) {
+    CircularBuffer<char> cb(8);
+    cb.push_back("abcdefgh", 8);
+    cb.push_back("ijk", 3);
+    ASSERT_FALSE(cb.is_linearized());
+
+    int segments = 0;
+    cb.for_each_segment([&segments](const char* first, const char* last) {
+        ++segments;
+        EXPECT_LT(first, last);
+    });
+    EXPECT_EQ(segments, 2);
+
+    std::string copied;
+    segmented_copy(cb, std::back_inserter(copied));
+    EXPECT_EQ(copied, "defghijk");
+
+    EXPECT_EQ(segmented_find(cb, 'j') - cb.begin(), 6);
+    EXPECT_EQ(segmented_find(cb, 'e') - cb.begin(), 1);
+    EXPECT_EQ(segmented_find(cb, 'z'), cb.end());
+
+    segmented_fill(cb, '*');
+    EXPECT_EQ(std::count(cb.begin(), cb.end(), '*'), 8);
+
+    CircularBuffer<char> empty;
+    EXPECT_EQ(segmented_find(empty, 'a'), empty.end());
+    EXPECT_TRUE(empty.begin() == empty.end());
+}
+
+// Хранилище с AlignedAllocator выровнено по строке кэша или по странице
+TEST(CircularBufferAllocatorTest, AlignedStorage) {
+    CircularBuffer<char, AlignedAllocator<char, cache_line_alignment>> line(100);
+    line.push_back('a');
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(&line[0]) % cache_line_alignment, 0u);
+
+    CircularBuffer<int, AlignedAllocator<int, page_alignment>> page(10, 7);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(page.linearize()) % page_alignment, 0u);
+
+    auto copy = page;
+    copy.set_capacity(20);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(copy.linearize()) % page_alignment, 0u);
+    EXPECT_EQ(copy[9], 7);
+}
+
+// Буферы берут память из арены и не обращаются к глобальной куче
+TEST(CircularBufferAllocatorTest, PmrArena) {
+    alignas(std::max_align_t) static char storage[16 * 1024];
+    std::pmr::monotonic_buffer_resource arena(storage, sizeof(storage), std::pmr::null_memory_resource());
+
+    for (int i = 0; i < 50; ++i) {
+        PmrCircularBuffer<int> cb(32, &arena);
+        for (int j = 0; j < 40; ++j) {
+            cb.push_back(j);
+        }
+        EXPECT_EQ(cb.front(), 8);
+        EXPECT_EQ(cb.get_allocator().resource(), &arena);
+    }
+
+    PmrCircularBuffer<std::pmr::string> strings(4, &arena);
+    strings.push_back("a string long enough to need its own allocation");
+    EXPECT_EQ(strings.front().get_allocator().resource(), &arena);
+    EXPECT_THROW(PmrCircularBuffer<char> huge(1 << 20, &arena), std::bad_alloc);
+}
+
+// Копирование и обмен сохраняют ресурс памяти каждого буфера
+TEST(CircularBufferAllocatorTest, PmrPropagation) {
+    std::pmr::unsynchronized_pool_resource pool_a;
+    std::pmr::unsynchronized_pool_resource pool_b;
+
+    PmrCircularBuffer<int> a(4, 1, &pool_a);
+    PmrCircularBuffer<int> b(6, 2, &pool_b);
+    a = b;
+    EXPECT_EQ(a.get_allocator().resource(), &pool_a);
+    EXPECT_EQ(a.size(), 6);
+    EXPECT_EQ(a[5], 2);
+
+    PmrCircularBuffer<int> c(b, &pool_a);
+    EXPECT_EQ(c.get_allocator().resource(), &pool_a);
+    EXPECT_TRUE(c == b);
+
+    // Перемещение в буфер с другим ресурсом копирует элементы
+    PmrCircularBuffer<int> d(std::move(b), &pool_a);
+    EXPECT_EQ(d.get_allocator().resource(), &pool_a);
+    EXPECT_EQ(d.size(), 6);
+    EXPECT_TRUE(b.empty());
+
+    PmrCircularBuffer<int> e(3, 9, &pool_a);
+    d.swap(e);
+    EXPECT_EQ(d.size(), 3);
+    EXPECT_EQ(e.size(), 6);
+    EXPECT_EQ(d.get_allocator().resource(), &pool_a);
+
+    PmrCircularBuffer<int> empty(&pool_b);
+    EXPECT_EQ(empty.capacity(), 0);
+    EXPECT_EQ(empty.get_allocator().resource(), &pool_b);
+}
+
+// Сравнение вставки и удаления с std::deque при случайных позициях
+template <class T, class MakeValue>
+static void CheckInsertEraseAgainstDeque(MakeValue make_value) {
+    CircularBuffer<T> cb(37);
+    std::deque<T> reference;
+    unsigned int x = 7;
+    for (int step = 0; step < 3000; ++step) {
+        x = x * 1103515245u + 12345u;
+        int op = (x >> 16) % 5;
+        int pos = static_cast<int>((x >> 4) % (reference.size() + 1));
+        if (op == 0 && !cb.full()) {
+            T value = make_value(step);
+            cb.insert(pos, value);
+            reference.insert(reference.begin() + pos, value);
+        } else if (op == 1 && cb.reserve() >= 3) {
+            std::vector<T> values = {make_value(step), make_value(step + 1), make_value(step + 2)};
+            cb.insert(pos, values.begin(), values.end());
+            reference.insert(reference.begin() + pos, values.begin(), values.end());
+        } else if (op == 2 && !reference.empty()) {
+            int last = std::min<int>(static_cast<int>(reference.size()), pos + 1 + static_cast<int>(x % 4));
+            int first = std::min(pos, last - 1);
+            cb.erase(first, last);
+            reference.erase(reference.begin() + first, reference.begin() + last);
+        } else if (op == 3) {
+            // Сдвигаем начало, чтобы проверить и свёрнутое расположение
+            cb.push_back(make_value(step));
+            reference.push_back(make_value(step));
+            if (static_cast<int>(reference.size()) > cb.capacity()) {
+                reference.pop_front();
+            }
+        } else if (!reference.empty()) {
+            cb.pop_front();
+            reference.pop_front();
+        }
+        ASSERT_EQ(cb.size(), static_cast<int>(reference.size()));
+        ASSERT_TRUE(std::equal(cb.begin(), cb.end(), reference.begin())) << "step " << step;
+    }
+}
+
+// Вставка и удаление сдвигают более короткую сторону и сохраняют порядок
+TEST(CircularBufferInsertEraseTest, MatchesDeque) {
+    CheckInsertEraseAgainstDeque<char>([](int i) { return static_cast<char>('a' + i % 26); });
+    CheckInsertEraseAgainstDeque<std::string>([](int i) { return std::string(20, static_cast<char>('a' + i % 26)); });
+}
+
+// Вставка у начала сдвигает начало буфера назад, а не весь хвост
+TEST(CircularBufferInsertEraseTest, ShiftsShorterSide) {
+    CircularBuffer<Tracked> cb(10);
+    for (int i = 0; i < 8; ++i) {
+        cb.push_back(Tracked(i));
+    }
+    cb.insert(1, Tracked(100));
+    EXPECT_EQ(Tracked::alive, 9);
+    EXPECT_EQ(cb[0].value, 0);
+    EXPECT_EQ(cb[1].value, 100);
+    EXPECT_EQ(cb[2].value, 1);
+    EXPECT_FALSE(cb.is_linearized());
+
+    std::vector<Tracked> more = {Tracked(200), Tracked(201)};
+    EXPECT_THROW(cb.insert(5, more.begin(), more.end()), std::runtime_error);
+    cb.pop_back();
+    cb.insert(5, more.begin(), more.end());
+    EXPECT_EQ(Tracked::alive, 12);
+    EXPECT_EQ(cb[5].value, 200);
+    EXPECT_EQ(cb[6].value, 201);
+    EXPECT_EQ(cb[7].value, 4);
+
+    cb.erase(1, 3);
+    cb.erase(4, 8);
+    EXPECT_EQ(cb.size(), 4);
+    EXPECT_EQ(Tracked::alive, 6);
+    EXPECT_EQ(cb[0].value, 0);
+    EXPECT_EQ(cb[1].value, 2);
+    EXPECT_EQ(cb[3].value, 200);
+    cb.clear();
+    EXPECT_EQ(Tracked::alive, 2);
+}
+
+// Поиск байта и последовательности, в том числе через конец массива
+TEST(CircularBufferSearchTest, FindAcrossWrap) {
+    CircularBuffer<char> cb(16);
+    cb.push_back("xxxxxxxxx", 9);
+    cb.consume(9);
+    cb.push_back("GET /\r\n\r\nbody", 13);
+    ASSERT_FALSE(cb.is_linearized());
+
+    EXPECT_EQ(cb.find('/'), 4);
+    EXPECT_EQ(cb.find('b'), 9);
+    EXPECT_EQ(cb.find('\n', 7), 8);
+    EXPECT_EQ(cb.find('z'), -1);
+    EXPECT_EQ(cb.find('y', 13), -1);
+    EXPECT_THROW(cb.find('y', 14), std::out_of_range);
+
+    // Разделитель "\r\n\r\n" начинается в первом куске и заканчивается во втором
+    EXPECT_EQ(cb.find("\r\n\r\n", 4), 5);
+    EXPECT_EQ(cb.find("\r\n", 2, 6), 7);
+    EXPECT_EQ(cb.find("body", 4), 9);
+    EXPECT_EQ(cb.find("bodyx", 5), -1);
+    EXPECT_EQ(cb.find("", 0, 3), 3);
+
+    EXPECT_EQ(segmented_count(cb, '\r'), 2);
+    EXPECT_EQ(segmented_count(cb, 'q'), 0);
+
+    CircularBuffer<std::string> words(3);
+    for (const char* w : {"a", "b", "c", "d"}) {
+        words.push_back(w);
+    }
+    std::string pair[] = {"c", "d"};
+    EXPECT_EQ(words.find(std::string("d")), 2);
+    EXPECT_EQ(words.find(pair, 2), 1);
+    EXPECT_EQ(segmented_count(words, std::string("b")), 1);
+}
+
+// Поиск совпадает с наивным на случайных данных и при любом сдвиге начала
+TEST(CircularBufferSearchTest, MatchesNaive) {
+    std::uint32_t seed = 7;
+    auto next = [&seed]() {
+        seed = seed * 1103515245u + 12345u;
+        return static_cast<char>('a' + (seed >> 16) % 3);
+    };
+    for (int shift = 0; shift < 100; shift += 7) {
+        CircularBuffer<char> cb(100);
+        std::string text(shift, ' ');
+        cb.push_back(text.data(), shift);
+        cb.consume(shift);
+        text.clear();
+        for (int i = 0; i < 100; ++i) {
+            text += next();
+        }
+        cb.push_back(text.data(), 100);
+        for (int len = 1; len <= 5; ++len) {
+            std::string needle = text.substr(static_cast<std::size_t>(len * 13), len);
+            needle[len - 1] = next();
+            for (int pos = 0; pos <= 100; pos += 11) {
+                std::size_t expected = text.find(needle, pos);
+                int got = cb.find(needle.data(), len, pos);
+                EXPECT_EQ(got, expected == std::string::npos ? -1 : static_cast<int>(expected));
+            }
+        }
+        EXPECT_EQ(segmented_count(cb, 'b'), std::count(text.begin(), text.end(), 'b'));
+    }
+}
+
+// Сравнение буферов с разными точками разреза
+TEST(CircularBufferSearchTest, EqualityAcrossSplits) {
+    std::string text = "0123456789";
+    CircularBuffer<char> a(10);
+    a.push_back(text.data(), 10);
+    for (int shift = 0; shift < 10; ++shift) {
+        CircularBuffer<char> b(12);
+        b.push_back(text.data(), shift);
+        b.consume(shift);
+        b.push_back(text.data(), 10);
+        EXPECT_TRUE(a == b);
+        b[9] = 'x';
+        EXPECT_TRUE(a != b);
+        b[9] = '9';
+        b[0] = 'x';
+        EXPECT_TRUE(a != b);
+    }
+
+    CircularBuffer<double> x(2), y(3);
+    x.push_back(0.0);
+    y.push_back(-0.0);
+    EXPECT_TRUE(x == y);
+}
+
+// Ключ, равенство которого определяется только полем id
+struct KeyOnly {
+    int id;
+    int payload;
+};
+
+static bool operator==(const KeyOnly& a, const KeyOnly& b) {
+    return a.id == b.id;
+}
+
+// Для классов сравнение идёт через их operator==, а не по байтам
+TEST(CircularBufferSearchTest, EqualityUsesElementOperator) {
+    CircularBuffer<KeyOnly> a(2), b(2);
+    a.push_back(KeyOnly{1, 10});
+    b.push_back(KeyOnly{1, 20});
+    EXPECT_TRUE(a[0] == b[0]);
+    EXPECT_TRUE(a == b);
+    b.push_back(KeyOnly{2, 10});
+    a.push_back(KeyOnly{3, 10});
+    EXPECT_TRUE(a != b);
+}
+
+// Пакетное потребление по участкам: функтор получает обе части, голова сдвигается один раз
+TEST(CircularBufferConsumeTest, SegmentsAcrossWrap) {
+    CircularBuffer<int> cb(5);
+    for (int i = 0; i < 7; ++i) {
+        cb.push_back(i);
+    }
+    std::vector<std::vector<int>> runs;
+    int n = cb.consume_up_to(4, [&runs](int* first, int* last) { runs.emplace_back(first, last); });
+    EXPECT_EQ(n, 4);
+    ASSERT_EQ(runs.size(), 2u);
+    EXPECT_EQ(runs[0], std::vector<int>({2, 3, 4}));
+    EXPECT_EQ(runs[1], std::vector<int>({5}));
+    ASSERT_EQ(cb.size(), 1);
+    EXPECT_EQ(cb.front(), 6);
+
+    EXPECT_EQ(cb.consume_up_to(10, [](int*, int*) {}), 1);
+    EXPECT_TRUE(cb.empty());
+    EXPECT_EQ(cb.consume_all([](int*, int*) { ADD_FAILURE(); }), 0);
+    EXPECT_THROW(cb.consume_up_to(-1, [](int*, int*) {}), std::invalid_argument);
+
+    CircularBuffer<int> zero;
+    EXPECT_EQ(zero.consume_all([](int&) { ADD_FAILURE(); }), 0);
+}
+
+// Поэлементный функтор; при исключении элементы остаются в буфере
+TEST(CircularBufferConsumeTest, PerElementAndThrow) {
+    CircularBuffer<std::string> cb(3);
+    cb.push_back("a");
+    cb.push_back("b");
+    cb.push_back("c");
+    cb.push_back("d");
+
+    EXPECT_THROW(cb.consume_all([](std::string& s) {
+        if (s == "c") {
+            throw std::runtime_error("stop");
+        }
+    }), std::runtime_error);
+    EXPECT_EQ(cb.size(), 3);
+
+    std::string joined;
+    EXPECT_EQ(cb.consume_all([&joined](const std::string& s) { joined += s; }), 3);
+    EXPECT_EQ(joined, "bcd");
+    EXPECT_TRUE(cb.empty());
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
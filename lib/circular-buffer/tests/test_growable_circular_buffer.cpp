@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+#include <deque>
+#include <string>
+#include <vector>
+#include "growable-circular-buffer.h"
+
+// Полный буфер растёт геометрически, а не перезаписывает элементы
+TEST(GrowableCircularBufferTest, GrowsInsteadOfOverwriting) {
+    GrowableCircularBuffer<int> cb(4);
+    for (int i = 0; i < 100; ++i) {
+        cb.push_back(i);
+    }
+    EXPECT_EQ(cb.size(), 100);
+    EXPECT_EQ(cb.capacity(), 128);
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(cb[i], i);
+    }
+
+    GrowableCircularBuffer<int> empty;
+    empty.push_front(1);
+    empty.push_front(0);
+    EXPECT_EQ(empty.front(), 0);
+    EXPECT_EQ(empty.back(), 1);
+
+    GrowableCircularBuffer<int> slow(10, 1.5);
+    for (int i = 0; i < 11; ++i) {
+        slow.push_back(i);
+    }
+    EXPECT_EQ(slow.capacity(), 15);
+
+    EXPECT_THROW(GrowableCircularBuffer<int> bad(4, 1.0), std::invalid_argument);
+    EXPECT_THROW(GrowableCircularBuffer<int> bad(4, 2.0, 0.5), std::invalid_argument);
+}
+
+// Рост сохраняет порядок свёрнутого буфера, в том числе при вставке в середину
+TEST(GrowableCircularBufferTest, KeepsOrderAcrossWrappedGrowth) {
+    GrowableCircularBuffer<std::string> cb(3);
+    std::deque<std::string> reference;
+    for (int i = 0; i < 50; ++i) {
+        std::string value(10, static_cast<char>('a' + i % 26));
+        if (i % 3 == 0) {
+            cb.push_front(value);
+            reference.push_front(value);
+        } else if (i % 3 == 1) {
+            cb.push_back(value);
+            reference.push_back(value);
+        } else {
+            int pos = cb.size() / 2;
+            cb.insert(pos, value);
+            reference.insert(reference.begin() + pos, value);
+        }
+        if (i % 7 == 0) {
+            cb.pop_front();
+            reference.pop_front();
+        }
+    }
+    std::vector<std::string> block(20, "block");
+    cb.insert(5, block.begin(), block.end());
+    reference.insert(reference.begin() + 5, block.begin(), block.end());
+    ASSERT_EQ(cb.size(), static_cast<int>(reference.size()));
+    EXPECT_TRUE(std::equal(cb.begin(), cb.end(), reference.begin()));
+}
+
+// Сжатие при низкой заполненности, но не ниже начальной ёмкости
+TEST(GrowableCircularBufferTest, ShrinksBelowThreshold) {
+    GrowableCircularBuffer<char> cb(8, 2.0, 0.25);
+    std::vector<char> data(1000, 'x');
+    cb.push_back(data.data(), 1000);
+    EXPECT_EQ(cb.capacity(), 1000);
+    cb.erase(0, 700);
+    EXPECT_EQ(cb.capacity(), 1000);
+    cb.erase(0, 60);
+    // 240 < 250: ёмкость уменьшается до size * 2
+    EXPECT_EQ(cb.capacity(), 480);
+    EXPECT_EQ(cb.size(), 240);
+    while (!cb.empty()) {
+        cb.pop_front();
+    }
+    EXPECT_EQ(cb.capacity(), 8);
+
+    GrowableCircularBuffer<char> no_shrink(8);
+    no_shrink.push_back(data.data(), 100);
+    no_shrink.erase(0, 99);
+    EXPECT_EQ(no_shrink.capacity(), 100);
+    no_shrink.shrink_to_fit();
+    EXPECT_EQ(no_shrink.capacity(), 8);
+    EXPECT_EQ(no_shrink.front(), 'x');
+}
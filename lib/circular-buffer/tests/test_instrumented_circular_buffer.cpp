@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include "instrumented-circular-buffer.h"
+
+// Счётчики вставок, удалений и перезаписей сходятся с размером буфера
+TEST(InstrumentedCircularBufferTest, CountsOperations) {
+    InstrumentedCircularBuffer<int, BufferStats> cb(4);
+    for (int i = 0; i < 6; ++i) {
+        cb.push_back(i);
+    }
+    cb.push_front(-1);
+    cb.emplace_back(7);
+    cb.pop_front();
+    cb.pop_back();
+    std::vector<int> data = {10, 11, 12, 13, 14, 15};
+    cb.push_back(data.data(), 6);
+    int out[2];
+    cb.pop_front(out, 2);
+    EXPECT_EQ(out[0], 12);
+
+    BufferStatsSnapshot s = cb.stats().snapshot();
+    EXPECT_EQ(s.capacity, 4);
+    EXPECT_EQ(s.pushes, 14u);
+    EXPECT_EQ(s.pops, 4u);
+    EXPECT_EQ(s.overwrites, 8u);
+    EXPECT_EQ(s.high_water, 4);
+    EXPECT_EQ(s.pushes - s.pops - s.overwrites, static_cast<std::uint64_t>(cb.size()));
+
+    cb.clear();
+    EXPECT_EQ(cb.stats().snapshot().pops, 6u);
+
+    cb.reset_stats();
+    s = cb.stats().snapshot();
+    EXPECT_EQ(s.pushes, 0u);
+    EXPECT_EQ(s.high_water, 0);
+}
+
+// Гистограмма заполненности раскладывает размеры по восьмым долям ёмкости
+TEST(InstrumentedCircularBufferTest, OccupancyHistogram) {
+    InstrumentedCircularBuffer<int, BufferStats> cb(16);
+    for (int i = 0; i < 16; ++i) {
+        cb.push_back(i);
+    }
+    BufferStatsSnapshot s = cb.stats().snapshot();
+    // Размеры 1..16: по два на каждую восьмую, 16 попадает в последнюю корзину
+    EXPECT_EQ(s.occupancy[0], 1u);
+    for (int i = 1; i < 7; ++i) {
+        EXPECT_EQ(s.occupancy[i], 2u);
+    }
+    EXPECT_EQ(s.occupancy[7], 3u);
+}
+
+// Время в заполненном состоянии накапливается, в том числе текущий отрезок
+TEST(InstrumentedCircularBufferTest, TimeAtFull) {
+    InstrumentedCircularBuffer<int, BufferStats> cb(2);
+    cb.push_back(1);
+    EXPECT_EQ(cb.stats().snapshot().time_at_full.count(), 0);
+    cb.push_back(2);
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    EXPECT_GE(cb.stats().snapshot().time_at_full, std::chrono::milliseconds(5));
+    cb.pop_front();
+    auto closed = cb.stats().snapshot().time_at_full;
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    EXPECT_EQ(cb.stats().snapshot().time_at_full, closed);
+}
+
+// Текстовый и JSON-дампы содержат все счётчики
+TEST(InstrumentedCircularBufferTest, Dumps) {
+    InstrumentedCircularBuffer<int, BufferStats> cb(8);
+    cb.push_back(1);
+    cb.push_back(2);
+    BufferStatsSnapshot s = cb.stats().snapshot();
+    std::string text = s.to_text();
+    EXPECT_NE(text.find("pushes 2\n"), std::string::npos);
+    EXPECT_NE(text.find("occupancy_12_25 1\n"), std::string::npos);
+    EXPECT_NE(text.find("occupancy_25_37 1\n"), std::string::npos);
+    EXPECT_EQ(s.to_json(),
+              "{\"capacity\":8,\"pushes\":2,\"pops\":0,\"overwrites\":0,\"high_water\":2,"
+              "\"time_at_full_ns\":0,\"occupancy\":[0,1,1,0,0,0,0,0]}");
+}
+
+// NullBufferStats ничего не считает, а буфер работает как обычно
+TEST(InstrumentedCircularBufferTest, NullStats) {
+    InstrumentedCircularBuffer<int, NullBufferStats> cb(2);
+    cb.push_back(1);
+    cb.push_back(2);
+    cb.push_back(3);
+    EXPECT_EQ(cb.front(), 2);
+    EXPECT_EQ(cb.stats().snapshot().pushes, 0u);
+}
+
+// Снимок можно брать из другого потока, пока владелец работает с буфером
+TEST(InstrumentedCircularBufferTest, ConcurrentSnapshot) {
+    InstrumentedCircularBuffer<int, BufferStats> cb(64);
+    std::atomic<bool> done(false);
+    std::thread reader([&] {
+        std::uint64_t last = 0;
+        while (!done.load()) {
+            std::uint64_t pushes = cb.stats().snapshot().pushes;
+            EXPECT_GE(pushes, last);
+            last = pushes;
+        }
+    });
+    for (int i = 0; i < 100000; ++i) {
+        cb.push_back(i);
+        if (i % 3 == 0) {
+            cb.pop_front();
+        }
+    }
+    done.store(true);
+    reader.join();
+    EXPECT_EQ(cb.stats().snapshot().pushes, 100000u);
+}
@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include <linux/mempolicy.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include "circular-buffer.h"
+#include "large-page-resource.h"
+
+// Буфер на обычных страницах: память выделяется отдельным отображением
+TEST(LargePageResourceTest, RegularPages) {
+    LargePageOptions options;
+    options.huge_pages = false;
+    LargePageResource resource(options);
+
+    PmrCircularBuffer<int> cb(1000, &resource);
+    for (int i = 0; i < 1500; ++i) {
+        cb.push_back(i);
+    }
+    EXPECT_EQ(cb.front(), 500);
+    EXPECT_EQ(cb.back(), 1499);
+    EXPECT_EQ(resource.last_backing().backing, PageBacking::Regular);
+    EXPECT_EQ(resource.last_backing().page_size, static_cast<std::size_t>(sysconf(_SC_PAGESIZE)));
+    EXPECT_FALSE(resource.last_backing().numa_bound);
+    EXPECT_FALSE(resource.last_backing().locked);
+}
+
+// Запрос больших страниц: система выдаёт явные или прозрачные страницы либо откатывается к обычным
+TEST(LargePageResourceTest, HugePagesWithFallback) {
+    LargePageResource resource;
+    PmrCircularBuffer<char> cb(3 << 20, &resource);
+    cb.push_back('a');
+    cb.push_back('b');
+    EXPECT_EQ(cb[1], 'b');
+
+    // Размер страницы соответствует фактически полученным страницам
+    PageBackingInfo info = resource.last_backing();
+    std::size_t huge = LargePageResource::huge_page_size();
+    if (info.backing != PageBacking::Regular) {
+        EXPECT_EQ(info.page_size, huge);
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(cb.linearize()) % huge, 0u);
+    } else {
+        EXPECT_EQ(info.page_size, static_cast<std::size_t>(sysconf(_SC_PAGESIZE)));
+    }
+}
+
+// Привязка к узлу NUMA и блокировка страниц в памяти
+TEST(LargePageResourceTest, NumaBindingAndLocking) {
+    LargePageOptions options;
+    options.huge_pages = false;
+    options.numa_node = 0;
+    options.lock = true;
+    LargePageResource resource(options);
+
+    PmrCircularBuffer<long> cb(4096, &resource);
+    for (int i = 0; i < 4096; ++i) {
+        cb.push_back(i);
+    }
+    EXPECT_EQ(cb.back(), 4095);
+    PageBackingInfo info = resource.last_backing();
+    EXPECT_EQ(info.backing, PageBacking::Regular);
+    EXPECT_EQ(info.page_size, static_cast<std::size_t>(sysconf(_SC_PAGESIZE)));
+    char* data = reinterpret_cast<char*>(cb.linearize());
+    std::size_t length = cb.capacity() * sizeof(long);
+
+    // Привязка обязана получиться, если узел 0 существует; страница должна лежать на нём
+    struct stat st;
+    if (stat("/sys/devices/system/node/node0", &st) == 0) {
+        EXPECT_TRUE(info.numa_bound);
+        int node = -1;
+        ASSERT_EQ(syscall(SYS_get_mempolicy, &node, nullptr, 0, data, MPOL_F_NODE | MPOL_F_ADDR), 0);
+        EXPECT_EQ(node, 0);
+    }
+
+    // Блокировка обязана получиться, если позволяет лимит; тогда все страницы в памяти
+    struct rlimit limit;
+    ASSERT_EQ(getrlimit(RLIMIT_MEMLOCK, &limit), 0);
+    if (geteuid() == 0 || limit.rlim_cur == RLIM_INFINITY || limit.rlim_cur >= 2 * length) {
+        EXPECT_TRUE(info.locked);
+    }
+    if (info.locked) {
+        std::size_t page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+        std::vector<unsigned char> resident((length + page - 1) / page);
+        ASSERT_EQ(mincore(data, length, resident.data()), 0);
+        for (unsigned char r : resident) {
+            EXPECT_TRUE(r & 1);
+        }
+    }
+}
+
+// Один ресурс в нескольких потоках: last_backing читается без гонок
+TEST(LargePageResourceTest, SharedBetweenThreads) {
+    LargePageOptions options;
+    options.huge_pages = false;
+    LargePageResource resource(options);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&resource] {
+            for (int i = 0; i < 50; ++i) {
+                PmrCircularBuffer<int> cb(1024, &resource);
+                cb.push_back(i);
+                EXPECT_EQ(resource.last_backing().backing, PageBacking::Regular);
+            }
+        });
+    }
+    for (std::thread& t : threads) {
+        t.join();
+    }
+}
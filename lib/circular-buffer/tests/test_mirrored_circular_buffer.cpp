@@ -0,0 +1,65 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include "mirrored-circular-buffer.h"
+
+// Ёмкость округляется до целого числа страниц
+TEST(MirroredCircularBufferTest, CapacityCoversWholePages) {
+    MirroredCircularBuffer<char> cb(100);
+    EXPECT_EQ(cb.capacity() % static_cast<int>(MirroredMapping::page_size()), 0);
+    EXPECT_GE(cb.capacity(), 100);
+
+    MirroredCircularBuffer<int> ints(1);
+    EXPECT_EQ(ints.capacity() * sizeof(int) % MirroredMapping::page_size(), 0u);
+
+    MirroredCircularBuffer<char> empty;
+    EXPECT_EQ(empty.capacity(), 0);
+    EXPECT_THROW(empty.push_back('a'), std::runtime_error);
+    EXPECT_THROW(MirroredCircularBuffer<char> bad(-1), std::invalid_argument);
+}
+
+// Окно через конец массива остаётся непрерывным без копирования
+TEST(MirroredCircularBufferTest, ContiguousAcrossWrap) {
+    MirroredCircularBuffer<char> cb(1);
+    const int cap = cb.capacity();
+    std::string filler(cap - 3, '.');
+    cb.push_back(filler.data(), static_cast<int>(filler.size()));
+    std::vector<char> sink(filler.size());
+    cb.pop_front(sink.data(), static_cast<int>(sink.size()));
+
+    cb.push_back("abcdefgh", 8); // Запись переходит через конец массива
+    const char* first = &cb[0];
+    EXPECT_EQ(std::string(cb.contiguous_view(0, 8), 8), "abcdefgh");
+    EXPECT_EQ(std::string(cb.contiguous_view(2, 4), 4), "cdef");
+    EXPECT_EQ(cb.linearize(), first);
+    EXPECT_TRUE(cb.is_linearized());
+    EXPECT_THROW(cb.contiguous_view(4, 5), std::out_of_range);
+}
+
+// Поведение при переполнении совпадает с CircularBuffer
+TEST(MirroredCircularBufferTest, OverwriteBehavior) {
+    MirroredCircularBuffer<char> cb(1);
+    const int cap = cb.capacity();
+    for (int i = 0; i < cap + 5; ++i) {
+        cb.push_back(static_cast<char>(i % 128));
+    }
+    EXPECT_TRUE(cb.full());
+    EXPECT_EQ(cb.front(), static_cast<char>(5 % 128));
+    EXPECT_EQ(cb.back(), static_cast<char>((cap + 4) % 128));
+
+    cb.push_front('z'); // Последний элемент будет переписан
+    EXPECT_EQ(cb.front(), 'z');
+    EXPECT_EQ(cb.back(), static_cast<char>((cap + 3) % 128));
+    EXPECT_EQ(cb.at(1), static_cast<char>(5 % 128));
+
+    cb.pop_back();
+    cb.pop_front();
+    EXPECT_EQ(cb.size(), cap - 2);
+    cb.clear();
+    EXPECT_TRUE(cb.empty());
+    EXPECT_THROW(cb.front(), std::runtime_error);
+
+    MirroredCircularBuffer<char> moved(std::move(cb));
+    EXPECT_EQ(moved.capacity(), cap);
+    EXPECT_EQ(cb.capacity(), 0);
+}
@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "mpmc-circular-buffer.h"
+
+// Однопоточная проверка FIFO, переполнения и округления ёмкости
+TEST(MpmcCircularBufferTest, SingleThreadFifo) {
+    MpmcCircularBuffer<std::string> q(3);
+    EXPECT_EQ(q.capacity(), 4);
+    EXPECT_TRUE(q.try_push("a"));
+    EXPECT_TRUE(q.try_push(std::string("b")));
+    EXPECT_TRUE(q.try_emplace(2, 'c'));
+    EXPECT_TRUE(q.try_push("d"));
+    EXPECT_FALSE(q.try_push("e"));
+    EXPECT_EQ(q.size(), 4);
+
+    std::string item;
+    EXPECT_TRUE(q.try_pop(item));
+    EXPECT_EQ(item, "a");
+    EXPECT_TRUE(q.try_push("e"));
+    for (const char* expected : {"b", "cc", "d", "e"}) {
+        EXPECT_TRUE(q.try_pop(item));
+        EXPECT_EQ(item, expected);
+    }
+    EXPECT_FALSE(q.try_pop(item));
+    EXPECT_TRUE(q.empty());
+
+    MpmcCircularBuffer<int> one(1);
+    EXPECT_EQ(one.capacity(), 2);
+
+    MpmcCircularBuffer<int> zero(0);
+    int value;
+    EXPECT_FALSE(zero.try_push(1));
+    EXPECT_FALSE(zero.try_pop(value));
+    EXPECT_THROW(MpmcCircularBuffer<int> bad(-1), std::invalid_argument);
+}
+
+// Пакетные операции захватывают несколько ячеек за одно обновление позиции
+TEST(MpmcCircularBufferTest, BatchOperations) {
+    MpmcCircularBuffer<int> q(8);
+    int data[10] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    EXPECT_EQ(q.try_push_n(data, 5), 5);
+    EXPECT_EQ(q.try_push_n(data + 5, 5), 3);
+    EXPECT_EQ(q.try_push_n(data, 1), 0);
+
+    int out[10];
+    EXPECT_EQ(q.try_pop_n(out, 6), 6);
+    for (int i = 0; i < 6; ++i) {
+        EXPECT_EQ(out[i], i);
+    }
+    EXPECT_EQ(q.try_push_n(data, 4), 4);
+    EXPECT_EQ(q.try_pop_n(out, 10), 6);
+    EXPECT_EQ(out[0], 6);
+    EXPECT_EQ(out[1], 7);
+    EXPECT_EQ(out[2], 0);
+    EXPECT_EQ(out[5], 3);
+    EXPECT_EQ(q.try_pop_n(out, 10), 0);
+}
+
+// Оставшиеся в очереди элементы уничтожаются деструктором
+TEST(MpmcCircularBufferTest, DestroysRemainingElements) {
+    auto shared = std::make_shared<int>(1);
+    {
+        MpmcCircularBuffer<std::shared_ptr<int>> q(4);
+        q.try_push(shared);
+        q.try_push(shared);
+        EXPECT_EQ(shared.use_count(), 3);
+    }
+    EXPECT_EQ(shared.use_count(), 1);
+}
+
+// Нагрузочный тест: несколько производителей и потребителей, каждый элемент доставлен ровно один раз
+TEST(MpmcCircularBufferTest, StressManyProducersManyConsumers) {
+    const int producers = 4;
+    const int consumers = 4;
+    const int per_producer = 100000;
+    MpmcCircularBuffer<int> q(64);
+    std::vector<std::atomic<int>> seen(producers * per_producer);
+    std::atomic<int> consumed(0);
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&q, p, per_producer] {
+            int batch[8];
+            for (int i = 0; i < per_producer;) {
+                if (i % 3 == 0) {
+                    if (q.try_push(p * per_producer + i)) {
+                        ++i;
+                    } else {
+                        std::this_thread::yield();
+                    }
+                    continue;
+                }
+                int n = std::min(8, per_producer - i);
+                for (int k = 0; k < n; ++k) {
+                    batch[k] = p * per_producer + i + k;
+                }
+                int pushed = q.try_push_n(batch, n);
+                if (pushed == 0) {
+                    std::this_thread::yield();
+                }
+                i += pushed;
+            }
+        });
+    }
+    for (int c = 0; c < consumers; ++c) {
+        threads.emplace_back([&q, &seen, &consumed, producers, per_producer] {
+            int batch[8];
+            while (consumed.load() < producers * per_producer) {
+                int n = q.try_pop_n(batch, 8);
+                if (n == 0) {
+                    std::this_thread::yield();
+                }
+                for (int k = 0; k < n; ++k) {
+                    seen[batch[k]].fetch_add(1);
+                }
+                consumed.fetch_add(n);
+            }
+        });
+    }
+    for (std::thread& t : threads) {
+        t.join();
+    }
+
+    int wrong = 0;
+    for (auto& count : seen) {
+        if (count.load() != 1) {
+            ++wrong;
+        }
+    }
+    EXPECT_EQ(wrong, 0);
+    EXPECT_TRUE(q.empty());
+}
@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "overflow-circular-buffer.h"
+
+// Политика по умолчанию перезаписывает старые элементы и считает их
+TEST(OverflowCircularBufferTest, OverwriteCountsEvicted) {
+    OverflowCircularBuffer<int> cb(3);
+    for (int i = 0; i < 5; ++i) {
+        EXPECT_TRUE(cb.push_back(i));
+    }
+    EXPECT_EQ(cb.dropped(), 2u);
+    EXPECT_EQ(cb.front(), 2);
+    EXPECT_EQ(cb.back(), 4);
+
+    EXPECT_TRUE(cb.push_front(10));
+    EXPECT_EQ(cb.dropped(), 3u);
+    EXPECT_EQ(cb.front(), 10);
+    EXPECT_EQ(cb.back(), 3);
+
+    std::vector<int> data = {20, 21, 22, 23, 24};
+    EXPECT_EQ(cb.push_back(data.data(), 5), 5);
+    EXPECT_EQ(cb.dropped(), 8u);
+    EXPECT_EQ(cb[0], 22);
+    EXPECT_EQ(cb[2], 24);
+
+    cb.reset_dropped();
+    EXPECT_EQ(cb.dropped(), 0u);
+
+    OverflowCircularBuffer<int> zero;
+    EXPECT_THROW(zero.push_back(1), std::runtime_error);
+    EXPECT_EQ(zero.dropped(), 0u);
+}
+
+// Отклоняющая политика не трогает буфер и возвращает false
+TEST(OverflowCircularBufferTest, RejectKeepsContents) {
+    OverflowCircularBuffer<std::string, RejectNew> cb(2);
+    EXPECT_TRUE(cb.push_back("a"));
+    EXPECT_TRUE(cb.emplace_front(1, 'b'));
+    EXPECT_FALSE(cb.push_back("c"));
+    EXPECT_FALSE(cb.push_front("d"));
+    EXPECT_FALSE(cb.emplace_back(3, 'e'));
+    EXPECT_EQ(cb.dropped(), 3u);
+    EXPECT_EQ(cb.front(), "b");
+    EXPECT_EQ(cb.back(), "a");
+
+    cb.pop_front();
+    std::vector<std::string> data = {"x", "y", "z"};
+    EXPECT_EQ(cb.push_back(data.data(), 3), 1);
+    EXPECT_EQ(cb.dropped(), 5u);
+    EXPECT_EQ(cb.back(), "x");
+
+    OverflowCircularBuffer<int, RejectNew> zero;
+    EXPECT_FALSE(zero.push_back(1));
+    EXPECT_EQ(zero.dropped(), 1u);
+}
+
+// Колбэк получает вытесняемые элементы в порядке их вытеснения
+TEST(OverflowCircularBufferTest, CallbackReceivesEvicted) {
+    std::vector<int> evicted;
+    auto on_evict = [&evicted](int& item) { evicted.push_back(item); };
+    typedef EvictCallback<decltype(on_evict)> Policy;
+    OverflowCircularBuffer<int, Policy> cb(3, Policy(on_evict));
+    for (int i = 0; i < 5; ++i) {
+        cb.push_back(i);
+    }
+    EXPECT_EQ(evicted, (std::vector<int>{0, 1}));
+
+    cb.push_front(-1);
+    EXPECT_EQ(evicted, (std::vector<int>{0, 1, 4}));
+
+    // Вытесняются все хранимые элементы и голова входного массива
+    std::vector<int> data = {10, 11, 12, 13, 14};
+    cb.push_back(data.data(), 5);
+    EXPECT_EQ(evicted, (std::vector<int>{0, 1, 4, -1, 2, 3, 10, 11}));
+    EXPECT_EQ(cb.dropped(), evicted.size());
+    EXPECT_EQ(cb[0], 12);
+}
+
+// Колбэк может забрать вытесняемый элемент перемещением
+TEST(OverflowCircularBufferTest, CallbackMovesFromEvicted) {
+    std::vector<std::unique_ptr<int>> spill;
+    auto on_evict = [&spill](std::unique_ptr<int>& item) { spill.push_back(std::move(item)); };
+    OverflowCircularBuffer<std::unique_ptr<int>, EvictCallback<decltype(on_evict)>> cb(
+        2, EvictCallback<decltype(on_evict)>(on_evict));
+    for (int i = 0; i < 4; ++i) {
+        cb.push_back(std::make_unique<int>(i));
+    }
+    ASSERT_EQ(spill.size(), 2u);
+    EXPECT_EQ(*spill[0], 0);
+    EXPECT_EQ(*spill[1], 1);
+    EXPECT_EQ(*cb.front(), 2);
+    EXPECT_EQ(*cb.back(), 3);
+}
@@ -0,0 +1,201 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "persistent-circular-buffer.h"
+
+// Уникальный путь во временном каталоге; файл удаляется в деструкторе
+struct TempRingPath {
+    std::string path;
+
+    explicit TempRingPath(const char* name)
+        : path(testing::TempDir() + "ring-" + std::to_string(getpid()) + "-" + name) {
+        std::remove(path.c_str());
+    }
+
+    ~TempRingPath() { std::remove(path.c_str()); }
+};
+
+// Содержимое переживает закрытие и повторное открытие файла
+TEST(PersistentCircularBufferTest, ReopenKeepsContents) {
+    TempRingPath file("reopen");
+    {
+        PersistentCircularBuffer<int> ring(file.path, 4);
+        EXPECT_TRUE(ring.empty());
+        EXPECT_EQ(ring.capacity(), 4);
+        ring.push_back(1);
+        ring.push_back(2);
+        ring.push_back(3);
+        ring.pop_front();
+        ring.checkpoint();
+    }
+    PersistentCircularBuffer<int> ring(file.path);
+    EXPECT_EQ(ring.capacity(), 4);
+    ASSERT_EQ(ring.size(), 2);
+    EXPECT_EQ(ring.front(), 2);
+    EXPECT_EQ(ring.back(), 3);
+    EXPECT_EQ(ring.first_sequence(), 1u);
+    EXPECT_THROW(ring.at(2), std::out_of_range);
+}
+
+// Переполнение перезаписывает старые элементы, в том числе при пакетной вставке
+TEST(PersistentCircularBufferTest, OverwriteAndWrap) {
+    TempRingPath file("wrap");
+    PersistentCircularBuffer<int> ring(file.path, 3);
+    for (int i = 0; i < 5; ++i) {
+        ring.push_back(i);
+    }
+    EXPECT_TRUE(ring.full());
+    EXPECT_EQ(ring[0], 2);
+    EXPECT_EQ(ring[2], 4);
+    EXPECT_EQ(ring.first_sequence(), 2u);
+
+    std::vector<int> data = {10, 11};
+    ring.push_back(data.data(), 2);
+    EXPECT_EQ(ring[0], 4);
+    EXPECT_EQ(ring[1], 10);
+    EXPECT_EQ(ring[2], 11);
+
+    std::vector<int> many = {20, 21, 22, 23, 24};
+    ring.push_back(many.data(), 5);
+    EXPECT_EQ(ring[0], 22);
+    EXPECT_EQ(ring[2], 24);
+    EXPECT_EQ(ring.first_sequence(), 9u);
+
+    // Участки идут по порядку и вместе дают все элементы
+    auto regions = ring.read_regions();
+    std::vector<int> seen;
+    for (const auto& region : regions) {
+        seen.insert(seen.end(), region.data, region.data + region.size);
+    }
+    EXPECT_EQ(seen, std::vector<int>({22, 23, 24}));
+    auto tail = ring.last_regions(2);
+    EXPECT_EQ(tail[0].size + tail[1].size, 2);
+    EXPECT_EQ(tail[0].data[0], 23);
+
+    ring.clear();
+    EXPECT_TRUE(ring.empty());
+    EXPECT_THROW(ring.pop_front(), std::runtime_error);
+    EXPECT_THROW(ring.front(), std::runtime_error);
+}
+
+// Элементы кольца по порядку
+static std::vector<int> contents(const PersistentCircularBuffer<int>& ring) {
+    std::vector<int> out;
+    for (int i = 0; i < ring.size(); ++i) {
+        out.push_back(ring[i]);
+    }
+    return out;
+}
+
+// Пакет длиннее ёмкости лежит в файле там же, где его ищут refresh и повторное открытие
+TEST(PersistentCircularBufferTest, OversizedBatchSurvivesReopen) {
+    TempRingPath file("oversized");
+    const std::vector<int> expected = {2, 3, 4, 5};
+    {
+        PersistentCircularBuffer<int> ring(file.path, 4);
+        ring.push_back(100);
+        std::vector<int> data = {0, 1, 2, 3, 4, 5};
+        ring.push_back(data.data(), 6);
+        EXPECT_EQ(contents(ring), expected);
+        EXPECT_EQ(ring.first_sequence(), 3u);
+
+        PersistentCircularBuffer<int> reader(file.path, 0, RingFileMode::ReadOnly);
+        EXPECT_EQ(contents(reader), expected);
+        ring.push_back(data.data(), 5);
+        reader.refresh();
+        EXPECT_EQ(contents(reader), std::vector<int>({1, 2, 3, 4}));
+        EXPECT_EQ(contents(ring), contents(reader));
+    }
+    PersistentCircularBuffer<int> ring(file.path);
+    EXPECT_EQ(contents(ring), std::vector<int>({1, 2, 3, 4}));
+    EXPECT_EQ(ring.first_sequence(), 8u);
+}
+
+// Кольцо только для чтения видит записи другого объекта после refresh
+TEST(PersistentCircularBufferTest, ReadOnlyView) {
+    TempRingPath file("view");
+    PersistentCircularBuffer<int> writer(file.path, 8);
+    writer.push_back(1);
+
+    PersistentCircularBuffer<int> reader(file.path, 0, RingFileMode::ReadOnly);
+    ASSERT_EQ(reader.size(), 1);
+    writer.push_back(2);
+    EXPECT_EQ(reader.size(), 1);
+    reader.refresh();
+    ASSERT_EQ(reader.size(), 2);
+    EXPECT_EQ(reader.back(), 2);
+
+    EXPECT_THROW(reader.push_back(3), std::runtime_error);
+    EXPECT_THROW(reader.consume(1), std::runtime_error);
+    EXPECT_EQ(writer.size(), 2);
+}
+
+// Чужие и несовместимые файлы не открываются
+TEST(PersistentCircularBufferTest, RejectsForeignFiles) {
+    TempRingPath file("foreign");
+    EXPECT_THROW(PersistentCircularBuffer<int>(file.path, 0, RingFileMode::OpenExisting), std::system_error);
+    EXPECT_THROW(PersistentCircularBuffer<int>(file.path, 0), std::invalid_argument);
+    {
+        PersistentCircularBuffer<int> ring(file.path, 4);
+    }
+    EXPECT_THROW(PersistentCircularBuffer<double>(file.path), std::runtime_error);
+    EXPECT_THROW(PersistentCircularBuffer<int>(file.path, 5), std::runtime_error);
+    EXPECT_NO_THROW(PersistentCircularBuffer<int>(file.path, 4, RingFileMode::OpenExisting));
+
+    TempRingPath garbage("garbage");
+    {
+        std::ofstream out(garbage.path);
+        out << "this is not a ring file, just some text long enough for a header";
+    }
+    EXPECT_THROW(PersistentCircularBuffer<int>(garbage.path), std::runtime_error);
+}
+
+// Счётчики, которые не может оставить ни один обрыв записи, исправляются при открытии
+TEST(PersistentCircularBufferTest, RepairsCounters) {
+    TempRingPath file("repair");
+    {
+        PersistentCircularBuffer<int> ring(file.path, 4);
+        for (int i = 0; i < 4; ++i) {
+            ring.push_back(i);
+        }
+    }
+    {
+        RingFile raw(file.path, sizeof(int), alignof(int), 4, RingFileMode::OpenExisting);
+        raw.header()->first.store(0);
+        raw.header()->last.store(10);
+    }
+    PersistentCircularBuffer<int> ring(file.path);
+    EXPECT_EQ(ring.size(), 4);
+    EXPECT_EQ(ring.first_sequence(), 6u);
+}
+
+// Процесс, завершившийся без деструкторов и msync, не теряет записанное
+TEST(PersistentCircularBufferTest, SurvivesCrash) {
+    TempRingPath file("crash");
+    {
+        PersistentCircularBuffer<int> ring(file.path, 16);
+        ring.push_back(100);
+    }
+    pid_t child = fork();
+    ASSERT_NE(child, -1);
+    if (child == 0) {
+        PersistentCircularBuffer<int> ring(file.path);
+        for (int i = 0; i < 20; ++i) {
+            ring.push_back(i);
+        }
+        _exit(0);
+    }
+    int status = 0;
+    ASSERT_EQ(waitpid(child, &status, 0), child);
+    ASSERT_TRUE(WIFEXITED(status));
+
+    PersistentCircularBuffer<int> ring(file.path);
+    ASSERT_EQ(ring.size(), 16);
+    EXPECT_EQ(ring.front(), 4);
+    EXPECT_EQ(ring.back(), 19);
+    EXPECT_EQ(ring.first_sequence(), 5u);
+}
@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+#include <deque>
+#include <string>
+#include <vector>
+#include "record-ring.h"
+
+// Возвращает содержимое записи строкой
+static std::string as_string(const RecordView& record) {
+    return std::string(record.data, record.size);
+}
+
+// Записи разной длины, включая пустую, читаются в порядке добавления
+TEST(RecordRingTest, PushPeekPop) {
+    RecordRing ring(30);
+    EXPECT_EQ(ring.capacity(), 32);
+    EXPECT_EQ(ring.max_record_size(), 28u);
+    EXPECT_TRUE(ring.empty());
+    EXPECT_THROW(ring.peek_record(), std::runtime_error);
+    EXPECT_THROW(ring.pop_record(), std::runtime_error);
+
+    EXPECT_TRUE(ring.push_record("hello", 5));
+    EXPECT_TRUE(ring.push_record("", 0));
+    EXPECT_TRUE(ring.push_record("abcd", 4));
+    EXPECT_EQ(ring.size(), 3);
+    // 4 + 8, 4 + 0, 4 + 4 байт
+    EXPECT_EQ(ring.bytes_used(), 24);
+
+    EXPECT_EQ(as_string(ring.peek_record()), "hello");
+    ring.pop_record();
+    EXPECT_EQ(ring.peek_record().size, 0u);
+    ring.pop_record();
+    EXPECT_EQ(as_string(ring.peek_record()), "abcd");
+    ring.pop_record();
+    EXPECT_TRUE(ring.empty());
+    EXPECT_EQ(ring.bytes_used(), 0);
+
+    EXPECT_THROW(ring.push_record("x", 29), std::invalid_argument);
+    EXPECT_TRUE(ring.push_record(std::string(28, 'z').data(), 28));
+    EXPECT_FALSE(ring.push_record("", 0));
+}
+
+// Запись, не помещающаяся до конца памяти, начинается сначала и остаётся непрерывной
+TEST(RecordRingTest, SkipsToStartInsteadOfWrapping) {
+    RecordRing ring(32);
+    EXPECT_TRUE(ring.push_record("0123456789", 10));   // 16 байт
+    EXPECT_TRUE(ring.push_record("abc", 3));           // 8 байт, до конца остаётся 8
+    ring.pop_record();
+
+    // 12 байт не помещаются в последние 8, пропуск занимает их
+    EXPECT_TRUE(ring.push_record("wrapped!", 8));
+    EXPECT_EQ(ring.bytes_used(), 8 + 8 + 12);
+    EXPECT_FALSE(ring.push_record("more", 4));
+
+    EXPECT_EQ(as_string(ring.peek_record()), "abc");
+    ring.pop_record();
+    RecordView record = ring.peek_record();
+    EXPECT_EQ(as_string(record), "wrapped!");
+    ring.pop_record();
+    EXPECT_TRUE(ring.empty());
+    EXPECT_EQ(ring.bytes_used(), 0);
+}
+
+// Пакетное чтение обходит обе части памяти и удаляет записи одним вызовом
+TEST(RecordRingTest, DrainBatch) {
+    RecordRing ring(64);
+    std::deque<std::string> expected;
+    std::vector<std::string> seen;
+    int next = 0;
+    // Много проходов по кругу с записями разной длины
+    for (int round = 0; round < 200; ++round) {
+        for (;;) {
+            std::string payload(next % 13, static_cast<char>('a' + next % 26));
+            if (!ring.push_record(payload.data(), payload.size())) {
+                break;
+            }
+            expected.push_back(payload);
+            ++next;
+        }
+        int limit = round % 3 + 1;
+        int n = ring.drain([&](RecordView record) { seen.push_back(as_string(record)); }, limit);
+        EXPECT_LE(n, limit);
+        EXPECT_EQ(ring.size(), static_cast<int>(expected.size()) - n);
+        for (int i = 0; i < n; ++i) {
+            ASSERT_EQ(seen[i], expected.front());
+            expected.pop_front();
+        }
+        seen.clear();
+    }
+    int rest = ring.drain([&](RecordView record) { seen.push_back(as_string(record)); });
+    EXPECT_EQ(rest, static_cast<int>(expected.size()));
+    EXPECT_EQ(std::vector<std::string>(expected.begin(), expected.end()), seen);
+    EXPECT_TRUE(ring.empty());
+    EXPECT_EQ(ring.drain([](RecordView) {}), 0);
+
+    ring.push_record("x", 1);
+    ring.clear();
+    EXPECT_TRUE(ring.empty());
+    EXPECT_EQ(ring.bytes_used(), 0);
+}
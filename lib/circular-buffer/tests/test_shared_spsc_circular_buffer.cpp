@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <sched.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "shared-spsc-circular-buffer.h"
+
+// Имя сегмента, уникальное для процесса теста
+static std::string shared_ring_name(const char* suffix) {
+    return "/cb-test-" + std::to_string(getpid()) + "-" + suffix;
+}
+
+// Одиночные и пакетные операции внутри одного процесса
+TEST(SharedSpscCircularBufferTest, PushPopWrap) {
+    SharedSpscCircularBuffer cb(shared_ring_name("basic"), 4);
+    EXPECT_EQ(cb.capacity(), 4);
+    EXPECT_TRUE(cb.empty());
+    EXPECT_TRUE(cb.try_push('a'));
+    EXPECT_TRUE(cb.try_push('b'));
+    EXPECT_TRUE(cb.try_push('c'));
+
+    SharedSpscCircularBuffer::value_type item;
+    EXPECT_TRUE(cb.try_pop(item));
+    EXPECT_EQ(item, 'a');
+
+    // Пакет переходит через конец буфера и обрезается по свободному месту
+    EXPECT_EQ(cb.try_push("defg", 4), 2);
+    EXPECT_EQ(cb.size(), 4);
+    EXPECT_FALSE(cb.try_push('x'));
+
+    char out[8] = {};
+    EXPECT_EQ(cb.try_pop(out, 8), 4);
+    EXPECT_EQ(std::string(out, 4), "bcde");
+    EXPECT_FALSE(cb.try_pop(item));
+    EXPECT_EQ(cb.try_pop(out, 8), 0);
+    EXPECT_THROW(cb.try_push(out, -1), std::invalid_argument);
+}
+
+// Пакетное потребление одной записью head
+TEST(SharedSpscCircularBufferTest, ConsumeBatches) {
+    SharedSpscCircularBuffer cb(shared_ring_name("consume"), 4);
+    cb.try_push("ab", 2);
+    SharedSpscCircularBuffer::value_type item;
+    cb.try_pop(item);
+    cb.try_push("cde", 3);
+
+    std::string seen;
+    EXPECT_EQ(cb.consume_up_to(2, [&seen](SharedSpscCircularBuffer::value_type c) { seen += c; }), 2);
+    EXPECT_EQ(cb.consume_all([&seen](const SharedSpscCircularBuffer::value_type* first, const SharedSpscCircularBuffer::value_type* last) {
+        seen.append(first, last);
+    }), 2);
+    EXPECT_EQ(seen, "bcde");
+    EXPECT_TRUE(cb.empty());
+}
+
+// Второй объект с тем же именем видит те же данные по другому адресу
+TEST(SharedSpscCircularBufferTest, AttachSharesData) {
+    SharedSpscCircularBuffer producer(shared_ring_name("attach"), 8);
+    SharedSpscCircularBuffer consumer(producer.name());
+    EXPECT_EQ(consumer.capacity(), 8);
+    EXPECT_TRUE(producer.try_push('q'));
+    EXPECT_EQ(consumer.size(), 1);
+
+    SharedSpscCircularBuffer::value_type item;
+    EXPECT_TRUE(consumer.try_pop(item));
+    EXPECT_EQ(item, 'q');
+    EXPECT_TRUE(producer.empty());
+
+    EXPECT_THROW(SharedSpscCircularBuffer(shared_ring_name("missing")), std::system_error);
+    EXPECT_THROW(SharedSpscCircularBuffer(shared_ring_name("negative"), -1), std::invalid_argument);
+}
+
+// Производитель и потребитель в разных процессах: порядок и содержимое сохраняются
+TEST(SharedSpscCircularBufferTest, TwoProcesses) {
+    const int total = 1 << 20;
+    SharedSpscCircularBuffer ring(shared_ring_name("fork"), 4096);
+    SharedSpscCircularBuffer result(shared_ring_name("result"), 16);
+
+    pid_t child = fork();
+    ASSERT_NE(child, -1);
+    if (child == 0) {
+        // Потребитель подключается по имени, как независимый процесс
+        SharedSpscCircularBuffer in(ring.name());
+        SharedSpscCircularBuffer out(result.name());
+        char buf[256];
+        unsigned char expected = 0;
+        bool ok = true;
+        for (int received = 0; received < total;) {
+            int n = in.try_pop(buf, sizeof(buf));
+            if (n == 0) {
+                sched_yield();
+            }
+            for (int i = 0; i < n; ++i, ++expected) {
+                ok = ok && static_cast<unsigned char>(buf[i]) == expected;
+            }
+            received += n;
+        }
+        out.try_push(ok ? 'y' : 'n');
+        _exit(0);
+    }
+
+    std::vector<char> data(1000);
+    unsigned char next = 0;
+    for (int sent = 0; sent < total;) {
+        int n = std::min(static_cast<int>(data.size()), total - sent);
+        for (int i = 0; i < n; ++i) {
+            data[i] = static_cast<char>(static_cast<unsigned char>(next + i));
+        }
+        int pushed = 0;
+        while (pushed < n) {
+            int k = ring.try_push(data.data() + pushed, n - pushed);
+            if (k == 0) {
+                sched_yield();
+            }
+            pushed += k;
+        }
+        next = static_cast<unsigned char>(next + n);
+        sent += n;
+    }
+
+    int status = 0;
+    ASSERT_EQ(waitpid(child, &status, 0), child);
+    ASSERT_TRUE(WIFEXITED(status));
+    SharedSpscCircularBuffer::value_type verdict = 0;
+    ASSERT_TRUE(result.try_pop(verdict));
+    EXPECT_EQ(verdict, 'y');
+    EXPECT_TRUE(ring.empty());
+}
@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include "simd-scan.h"
+
+// Прогоняет проверку на каждом уровне ядер, который поддерживает процессор
+template <class F>
+static void for_each_level(F check) {
+    ScanLevel best = scan_level();
+    for (ScanLevel level : {ScanLevel::Scalar, ScanLevel::Sse2, ScanLevel::Avx2}) {
+        if (set_scan_level(level) == level) {
+            check(level);
+        }
+    }
+    set_scan_level(best);
+}
+
+static std::string random_text(std::size_t n, std::uint32_t seed, int alphabet) {
+    std::string text(n, ' ');
+    for (char& c : text) {
+        seed = seed * 1103515245u + 12345u;
+        c = static_cast<char>('a' + (seed >> 16) % alphabet);
+    }
+    return text;
+}
+
+// Поиск и подсчёт байта на всех длинах и смещениях, включая хвосты короче вектора
+TEST(SimdScanTest, FindAndCount) {
+    std::string text = random_text(300, 1, 20);
+    for_each_level([&](ScanLevel level) {
+        for (std::size_t from = 0; from < 70; ++from) {
+            for (std::size_t len : {0u, 1u, 15u, 16u, 17u, 31u, 32u, 33u, 63u, 64u, 65u, 200u}) {
+                const char* first = text.data() + from;
+                const char* last = first + len;
+                for (char value : {'a', 'k', 't', 'z'}) {
+                    EXPECT_EQ(scan_find(first, last, value), std::find(first, last, value))
+                        << static_cast<int>(level) << ' ' << from << ' ' << len;
+                    EXPECT_EQ(scan_count(first, last, value),
+                              static_cast<std::size_t>(std::count(first, last, value)));
+                }
+            }
+        }
+        // Подсчёт дольше 255 шагов не переполняет байтовые счётчики
+        std::string same(100000, 'q');
+        EXPECT_EQ(scan_count(same.data(), same.data() + same.size(), 'q'), same.size());
+        EXPECT_EQ(scan_find(same.data(), same.data() + same.size(), '\xff'), same.data() + same.size());
+    });
+}
+
+// Поиск подстроки совпадает с std::string::find
+TEST(SimdScanTest, Search) {
+    std::string text = random_text(500, 2, 3) + "\r\n\r\n" + random_text(100, 3, 3);
+    for_each_level([&](ScanLevel) {
+        for (std::size_t n = 0; n <= 40; n += (n < 6 ? 1 : 7)) {
+            for (std::size_t at = 0; at + n <= text.size(); at += 37) {
+                std::string needle = text.substr(at, n);
+                const char* hit = scan_search(text.data(), text.data() + text.size(), needle.data(), n);
+                EXPECT_EQ(hit - text.data(), static_cast<std::ptrdiff_t>(text.find(needle)));
+            }
+        }
+        const char* end = text.data() + text.size();
+        EXPECT_EQ(scan_search(text.data(), end, "\r\n\r\n", 4) - text.data(), 500);
+        EXPECT_EQ(scan_search(text.data(), end, "abcabcx", 7), end);
+        EXPECT_EQ(scan_search(text.data(), text.data() + 3, "abcd", 4), text.data() + 3);
+    });
+}
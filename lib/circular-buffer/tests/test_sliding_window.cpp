@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <random>
+#include "sliding-window.h"
+
+// Агрегаты окна совпадают с пересчётом по всем элементам
+template <class T>
+static void expect_matches(const SlidingWindow<T>& window, const std::deque<T>& naive) {
+    ASSERT_EQ(window.size(), static_cast<int>(naive.size()));
+    if (naive.empty()) {
+        return;
+    }
+    double sum = 0;
+    for (T x : naive) {
+        sum += x;
+    }
+    double mean = sum / naive.size();
+    double squares = 0;
+    for (T x : naive) {
+        squares += (x - mean) * (x - mean);
+    }
+    EXPECT_NEAR(static_cast<double>(window.sum()), sum, 1e-6 * (1 + std::fabs(sum)));
+    EXPECT_NEAR(window.mean(), mean, 1e-6 * (1 + std::fabs(mean)));
+    EXPECT_NEAR(window.variance(), squares / naive.size(), 1e-6 * (1 + squares / naive.size()));
+    EXPECT_EQ(window.min(), *std::min_element(naive.begin(), naive.end()));
+    EXPECT_EQ(window.max(), *std::max_element(naive.begin(), naive.end()));
+    EXPECT_EQ(window.front(), naive.front());
+    EXPECT_EQ(window.back(), naive.back());
+}
+
+// Простой пример с вытеснением при переполнении
+TEST(SlidingWindowTest, Basics) {
+    SlidingWindow<int> window(3);
+    EXPECT_TRUE(window.empty());
+    EXPECT_EQ(window.sum(), 0);
+    EXPECT_THROW(window.min(), std::runtime_error);
+    EXPECT_THROW(window.mean(), std::runtime_error);
+    EXPECT_THROW(window.pop_front(), std::runtime_error);
+
+    window.push_back(5);
+    window.push_back(1);
+    window.push_back(3);
+    EXPECT_TRUE(window.full());
+    EXPECT_EQ(window.sum(), 9);
+    EXPECT_EQ(window.min(), 1);
+    EXPECT_EQ(window.max(), 5);
+    EXPECT_DOUBLE_EQ(window.mean(), 3.0);
+    EXPECT_DOUBLE_EQ(window.variance(), 8.0 / 3);
+    EXPECT_DOUBLE_EQ(window.sample_variance(), 4.0);
+
+    // 5 вытесняется, максимум переходит к 4
+    window.push_back(4);
+    EXPECT_EQ(window.sum(), 8);
+    EXPECT_EQ(window.max(), 4);
+    EXPECT_EQ(window.min(), 1);
+    EXPECT_EQ(window[0], 1);
+
+    window.pop_front();
+    EXPECT_EQ(window.min(), 3);
+    window.clear();
+    EXPECT_TRUE(window.empty());
+    window.push_back(7);
+    EXPECT_EQ(window.min(), 7);
+    EXPECT_EQ(window.max(), 7);
+    EXPECT_DOUBLE_EQ(window.variance(), 0.0);
+    EXPECT_DOUBLE_EQ(window.sample_variance(), 0.0);
+
+    SlidingWindow<int> zero(0);
+    EXPECT_THROW(zero.push_back(1), std::runtime_error);
+}
+
+// Случайные вставки и удаления против наивного пересчёта, с повторяющимися значениями
+TEST(SlidingWindowTest, MatchesNaiveInt) {
+    std::mt19937 rng(7);
+    SlidingWindow<int> window(17);
+    std::deque<int> naive;
+    for (int step = 0; step < 5000; ++step) {
+        if (rng() % 5 == 0 && !naive.empty()) {
+            window.pop_front();
+            naive.pop_front();
+        } else {
+            int x = static_cast<int>(rng() % 21) - 10;
+            window.push_back(x);
+            naive.push_back(x);
+            if (naive.size() > 17) {
+                naive.pop_front();
+            }
+        }
+        expect_matches(window, naive);
+    }
+}
+
+TEST(SlidingWindowTest, MatchesNaiveDouble) {
+    std::mt19937 rng(11);
+    std::normal_distribution<double> dist(1000.0, 25.0);
+    SlidingWindow<double> window(64);
+    std::deque<double> naive;
+    for (int step = 0; step < 100000; ++step) {
+        double x = dist(rng);
+        window.push_back(x);
+        naive.push_back(x);
+        if (naive.size() > 64) {
+            naive.pop_front();
+        }
+        if (step % 997 == 0) {
+            expect_matches(window, naive);
+        }
+    }
+    // Пересчёт даёт те же значения
+    double mean = window.mean();
+    double variance = window.variance();
+    window.recompute();
+    EXPECT_NEAR(window.mean(), mean, 1e-9 * mean);
+    EXPECT_NEAR(window.variance(), variance, 1e-6 * variance);
+    expect_matches(window, naive);
+}
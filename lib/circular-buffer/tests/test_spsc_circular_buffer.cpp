@@ -0,0 +1,207 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include "spsc-circular-buffer.h"
+
+// Тестирование try_push и try_pop в режиме Reject
+TEST(SpscCircularBufferTest, RejectWhenFull) {
+    SpscCircularBuffer cb(3);
+    EXPECT_EQ(cb.capacity(), 3);
+    EXPECT_EQ(cb.overflow_mode(), OverflowMode::Reject);
+    EXPECT_TRUE(cb.try_push('a'));
+    EXPECT_TRUE(cb.try_push('b'));
+    EXPECT_TRUE(cb.try_push('c'));
+    EXPECT_FALSE(cb.try_push('d'));
+    EXPECT_EQ(cb.size(), 3);
+
+    SpscCircularBuffer::value_type item;
+    EXPECT_TRUE(cb.try_pop(item));
+    EXPECT_EQ(item, 'a');
+    EXPECT_TRUE(cb.try_push('d'));
+    EXPECT_TRUE(cb.try_pop(item));
+    EXPECT_EQ(item, 'b');
+    EXPECT_TRUE(cb.try_pop(item));
+    EXPECT_EQ(item, 'c');
+    EXPECT_TRUE(cb.try_pop(item));
+    EXPECT_EQ(item, 'd');
+    EXPECT_FALSE(cb.try_pop(item));
+    EXPECT_TRUE(cb.empty());
+}
+
+// Тестирование перезаписи старейшего элемента в режиме Overwrite
+TEST(SpscCircularBufferTest, OverwriteWhenFull) {
+    SpscCircularBuffer cb(3, OverflowMode::Overwrite);
+    for (char c = 'a'; c <= 'e'; ++c) {
+        EXPECT_TRUE(cb.try_push(c));
+    }
+    EXPECT_EQ(cb.size(), 3);
+
+    SpscCircularBuffer::value_type item;
+    EXPECT_TRUE(cb.try_pop(item));
+    EXPECT_EQ(item, 'c');
+    EXPECT_TRUE(cb.try_pop(item));
+    EXPECT_EQ(item, 'd');
+    EXPECT_TRUE(cb.try_pop(item));
+    EXPECT_EQ(item, 'e');
+    EXPECT_FALSE(cb.try_pop(item));
+}
+
+// Тестирование буфера нулевой ёмкости и исключений конструктора
+TEST(SpscCircularBufferTest, ZeroCapacity) {
+    SpscCircularBuffer reject(0);
+    SpscCircularBuffer overwrite(0, OverflowMode::Overwrite);
+    SpscCircularBuffer::value_type item;
+    EXPECT_FALSE(reject.try_push('a'));
+    EXPECT_FALSE(overwrite.try_push('a'));
+    EXPECT_FALSE(reject.try_pop(item));
+    EXPECT_THROW(SpscCircularBuffer cb(-1), std::invalid_argument);
+}
+
+// Нагрузочный тест: производитель и потребитель в разных потоках
+TEST(SpscCircularBufferTest, StressReject) {
+    const int total = 1000000;
+    SpscCircularBuffer cb(64);
+
+    std::thread producer([&cb, total] {
+        for (int i = 0; i < total; ++i) {
+            while (!cb.try_push(static_cast<SpscCircularBuffer::value_type>(i))) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    int mismatches = 0;
+    for (int i = 0; i < total; ++i) {
+        SpscCircularBuffer::value_type item;
+        while (!cb.try_pop(item)) {
+            std::this_thread::yield();
+        }
+        if (item != static_cast<SpscCircularBuffer::value_type>(i)) {
+            ++mismatches;
+        }
+    }
+    producer.join();
+
+    EXPECT_EQ(mismatches, 0);
+    EXPECT_TRUE(cb.empty());
+}
+
+// Нагрузочный тест в режиме Overwrite: потребитель видит строго возрастающую
+// последовательность без устаревших и переставленных элементов, а после остановки
+// производителя в буфере остаются последние элементы
+TEST(SpscCircularBufferTest, StressOverwrite) {
+    const int total = 1000000;
+    // Элемент хранит номер по модулю 128; производитель опережает потребителя
+    // не больше чем на ahead, поэтому номер восстанавливается однозначно
+    const int period = 128;
+    const int ahead = 100;
+    SpscCircularBuffer cb(2, OverflowMode::Overwrite);
+    std::atomic<int> seen(-1);
+    std::atomic<bool> done(false);
+
+    std::thread producer([&cb, &seen, &done, total, period, ahead] {
+        for (int i = 0; i < total; ++i) {
+            while (i - seen.load(std::memory_order_acquire) > ahead) {
+                std::this_thread::yield();
+            }
+            cb.try_push(static_cast<SpscCircularBuffer::value_type>(i % period));
+        }
+        done.store(true, std::memory_order_release);
+    });
+
+    int last = -1;
+    int not_increasing = 0;
+    SpscCircularBuffer::value_type item;
+    while (!done.load(std::memory_order_acquire)) {
+        if (!cb.try_pop(item)) {
+            std::this_thread::yield();
+            continue;
+        }
+        // Устаревший или повторный элемент даёт шаг 0 или больше ahead
+        int step = ((item - last) % period + period) % period;
+        if (step == 0 || step > ahead) {
+            ++not_increasing;
+        }
+        last += step;
+        seen.store(last, std::memory_order_release);
+    }
+    producer.join();
+
+    EXPECT_EQ(not_increasing, 0);
+    EXPECT_LT(last, total);
+    EXPECT_LE(cb.size(), 2);
+
+    // Последние записанные элементы: (total - k) % period
+    int remaining = cb.size();
+    for (int k = remaining; k > 0; --k) {
+        ASSERT_TRUE(cb.try_pop(item));
+        EXPECT_EQ(item, static_cast<SpscCircularBuffer::value_type>((total - k) % period));
+    }
+    EXPECT_TRUE(cb.empty());
+}
+
+// Пакетное потребление в режиме Reject: участки идут по порядку и через конец буфера
+TEST(SpscCircularBufferTest, ConsumeBatches) {
+    SpscCircularBuffer cb(4);
+    for (char c : std::string("abc")) {
+        cb.try_push(c);
+    }
+    SpscCircularBuffer::value_type item;
+    cb.try_pop(item);
+    cb.try_pop(item);
+    for (char c : std::string("def")) {
+        cb.try_push(c);
+    }
+
+    std::string seen;
+    int runs = 0;
+    EXPECT_EQ(cb.consume_up_to(3, [&](const SpscCircularBuffer::value_type* first, const SpscCircularBuffer::value_type* last) {
+        seen.append(first, last);
+        ++runs;
+    }), 3);
+    EXPECT_EQ(seen, "cde");
+    EXPECT_EQ(runs, 2);
+    EXPECT_EQ(cb.consume_all([&seen](SpscCircularBuffer::value_type c) { seen += c; }), 1);
+    EXPECT_EQ(seen, "cdef");
+    EXPECT_EQ(cb.consume_all([](SpscCircularBuffer::value_type) { ADD_FAILURE(); }), 0);
+
+    SpscCircularBuffer overwrite(2, OverflowMode::Overwrite);
+    for (char c : std::string("xyz")) {
+        overwrite.try_push(c);
+    }
+    seen.clear();
+    EXPECT_EQ(overwrite.consume_all([&](const SpscCircularBuffer::value_type* first, const SpscCircularBuffer::value_type* last) {
+        seen.append(first, last);
+    }), 2);
+    EXPECT_EQ(seen, "yz");
+}
+
+// Нагрузочный тест: потребитель забирает элементы пакетами
+TEST(SpscCircularBufferTest, StressConsumeBatches) {
+    const int total = 1000000;
+    SpscCircularBuffer cb(64);
+
+    std::thread producer([&cb, total] {
+        for (int i = 0; i < total; ++i) {
+            while (!cb.try_push(static_cast<SpscCircularBuffer::value_type>(i))) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    int received = 0;
+    int mismatches = 0;
+    while (received < total) {
+        int n = cb.consume_all([&](SpscCircularBuffer::value_type item) {
+            mismatches += item != static_cast<SpscCircularBuffer::value_type>(received++);
+        });
+        if (n == 0) {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+
+    EXPECT_EQ(received, total);
+    EXPECT_EQ(mismatches, 0);
+    EXPECT_TRUE(cb.empty());
+}
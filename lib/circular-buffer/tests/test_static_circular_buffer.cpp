@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <memory>
+#include <string>
+#include "circular-buffer.h"
+#include "static-circular-buffer.h"
+
+// Ёмкость известна на этапе компиляции, хранилище лежит внутри объекта
+TEST(StaticCircularBufferTest, InlineStorage) {
+    static_assert(StaticCircularBuffer<char, 16>::capacity() == 16, "capacity must be constexpr");
+    EXPECT_LE(sizeof(StaticCircularBuffer<char, 16>), 16 + 2 * sizeof(int));
+
+    StaticCircularBuffer<int, 4> cb;
+    EXPECT_TRUE(cb.empty());
+    EXPECT_EQ(cb.reserve(), 4);
+    EXPECT_THROW(cb.front(), std::runtime_error);
+    EXPECT_THROW(cb.pop_back(), std::runtime_error);
+
+    StaticCircularBuffer<int, 3> filled(7);
+    EXPECT_TRUE(filled.full());
+    EXPECT_EQ(filled[2], 7);
+}
+
+// Поведение совпадает с CircularBuffer той же ёмкости
+TEST(StaticCircularBufferTest, MatchesCircularBuffer) {
+    StaticCircularBuffer<int, 5> fixed;
+    CircularBuffer<int> dynamic(5);
+    unsigned int x = 1;
+    for (int step = 0; step < 2000; ++step) {
+        x = x * 1103515245u + 12345u;
+        int op = (x >> 16) % 7;
+        int value = static_cast<int>(x >> 8) % 100;
+        if (op == 0 || op == 1) {
+            fixed.push_back(value);
+            dynamic.push_back(value);
+        } else if (op == 2) {
+            fixed.push_front(value);
+            dynamic.push_front(value);
+        } else if (op == 3 && !dynamic.empty()) {
+            fixed.pop_front();
+            dynamic.pop_front();
+        } else if (op == 4 && !dynamic.empty()) {
+            fixed.pop_back();
+            dynamic.pop_back();
+        } else if (op == 5 && !dynamic.full()) {
+            int pos = value % (dynamic.size() + 1);
+            fixed.insert(pos, value);
+            dynamic.insert(pos, value);
+        } else if (op == 6 && dynamic.size() > 1) {
+            fixed.erase(0, 2);
+            dynamic.erase(0, 2);
+        }
+        ASSERT_EQ(fixed.size(), dynamic.size());
+        ASSERT_TRUE(std::equal(fixed.begin(), fixed.end(), dynamic.begin()));
+    }
+    fixed.linearize();
+    EXPECT_TRUE(fixed.is_linearized());
+    EXPECT_TRUE(std::equal(fixed.begin(), fixed.end(), dynamic.begin()));
+    EXPECT_THROW(fixed.at(5), std::out_of_range);
+}
+
+// Нетривиальные элементы: копирование, перемещение, обмен и уничтожение
+TEST(StaticCircularBufferTest, NonTrivialElements) {
+    auto shared = std::make_shared<int>(0);
+    {
+        StaticCircularBuffer<std::shared_ptr<int>, 3> cb;
+        cb.push_back(shared);
+        cb.push_back(shared);
+        cb.emplace_front(shared);
+        cb.push_back(shared);
+        EXPECT_EQ(shared.use_count(), 4);
+
+        StaticCircularBuffer<std::shared_ptr<int>, 3> copy(cb);
+        EXPECT_EQ(shared.use_count(), 7);
+        StaticCircularBuffer<std::shared_ptr<int>, 3> moved(std::move(copy));
+        EXPECT_TRUE(copy.empty());
+        EXPECT_EQ(shared.use_count(), 7);
+        moved.pop_front();
+        moved.swap(cb);
+        EXPECT_EQ(moved.size(), 3);
+        EXPECT_EQ(cb.size(), 2);
+        cb.clear();
+        EXPECT_EQ(shared.use_count(), 4);
+    }
+    EXPECT_EQ(shared.use_count(), 1);
+
+    StaticCircularBuffer<std::string, 2> strings;
+    strings.push_back("first");
+    strings.push_back("second");
+    strings.push_back("third");
+    StaticCircularBuffer<std::string, 2> other;
+    other = strings;
+    EXPECT_TRUE(other == strings);
+    EXPECT_EQ(other.front(), "second");
+    EXPECT_EQ(other.linearize()[1], "third");
+}